@@ -0,0 +1,610 @@
+// Rasterizer microbenchmarks
+// Sweeps line length, octant and subpixel endpoints for bresenhamLine (per pixel, double-step and
+// run sliced) and xiaolinWuLine (float at every SIMD level, packed, fixed point and two-ended fixed point), plus the sine wave generator of the demo, M4
+// decimation of a dense series and direct vs
+// tile-binned drawing into a 4K CPU framebuffer, and writes the
+// results as JSON so runs can be compared between releases.
+//
+// usage: Bench [--out results.json] [--min-time seconds] [--filter substring] [--verify]
+//
+// --verify checks the double-step and two-ended variants against the
+// rasterizers they replace over the sweep and random lines, xiaolinWuLine at
+// every SIMD level the CPU supports against the scalar loop, and straight
+// lines split into polylines against the unsplit line pixel by pixel. It
+// prints an ERROR for every line that differs and exits with 1 if any did.
+//
+// Each benchmark is timed until it has run for --min-time, repeated
+// REPETITIONS times, and the median repetition is reported.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "Framebuffer.h"
+#include "Polyline.h"
+#include "Rasterizer.h"
+#include "SeriesLod.h"
+#include "TileRasterizer.h"
+#include "WuSimd.h"
+
+// ---------- Allocation counting ----------
+// Every global new in the process goes through here, so a benchmark can
+// report how many heap allocations one call makes.
+static std::atomic<size_t> allocationCount{ 0 };
+
+void* operator new(size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+// ---------- Harness ----------
+
+const int REPETITIONS = 5;
+const int WIDTH = 1280;
+const int HEIGHT = 720;
+
+// Keeps the optimizer from dropping a result
+static volatile float sink;
+static void keep(float v) { sink = v; }
+
+struct Result {
+    std::string name;
+    std::string algorithm;
+    int length = 0;
+    int octant = -1;
+    bool steep = false;
+    bool subpixel = false;
+    size_t iterations = 0;
+    double nsPerCall = 0.0;
+    double pixelsPerCall = 0.0;
+    double allocsPerCall = 0.0;
+};
+
+// body() runs one call and returns the number of pixels (vertices) it produced
+static Result run(const std::string& name, double minTime, const std::function<size_t()>& body) {
+    using Clock = std::chrono::steady_clock;
+    Result result;
+    result.name = name;
+
+    // Warm up and measure pixels / allocations of a single call
+    size_t before = allocationCount.load(std::memory_order_relaxed);
+    size_t pixels = body();
+    result.allocsPerCall = double(allocationCount.load(std::memory_order_relaxed) - before);
+    result.pixelsPerCall = double(pixels);
+
+    // Scale the iteration count until one repetition takes minTime
+    size_t iterations = 1;
+    while (true) {
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) body();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        if (seconds >= minTime || iterations >= (size_t(1) << 30))
+            break;
+        double scale = seconds > 0.0 ? 1.4 * minTime / seconds : 10.0;
+        iterations = std::max(iterations + 1, size_t(double(iterations) * std::min(scale, 10.0)));
+    }
+
+    std::vector<double> samples;
+    for (int r = 0; r < REPETITIONS; ++r) {
+        Clock::time_point start = Clock::now();
+        for (size_t i = 0; i < iterations; ++i) body();
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        samples.push_back(ns / double(iterations));
+    }
+    std::sort(samples.begin(), samples.end());
+
+    result.iterations = iterations;
+    result.nsPerCall = samples[samples.size() / 2];
+    return result;
+}
+
+// ---------- Line sweep ----------
+
+// Line of the given length from the screen center through the middle of an octant
+// Octants 1, 2, 5 and 6 are steep (|dy| > |dx|). Subpixel lines move both
+// endpoints off the pixel grid, integer lines start and end on pixel corners.
+static Line sweepLine(int length, int octant, bool subpixel) {
+    double angle = (octant * 45.0 + 22.5) * 3.14159265358979 / 180.0;
+    float x0 = WIDTH / 2.0f, y0 = HEIGHT / 2.0f;
+    float x1 = x0 + static_cast<float>(std::round(length * std::cos(angle)));
+    float y1 = y0 + static_cast<float>(std::round(length * std::sin(angle)));
+    if (subpixel) {
+        x0 += 0.37f; y0 += 0.61f;
+        x1 += 0.83f; y1 += 0.19f;
+    }
+    return { x0, y0, x1, y1 };
+}
+
+// Lower case level name for benchmark names
+static std::string simdTag(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE41: return "sse41";
+    case SimdLevel::AVX: return "avx";
+    case SimdLevel::NEON: return "neon";
+    default: return "scalar";
+    }
+}
+
+static std::string jsonEscape(const std::string& s) {
+    std::string out;
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// ---------- Exactness of the variants ----------
+
+// Output of each variant compared with its reference, byte for byte
+static bool verifyLine(int bx0, int by0, int bx1, int by1, Fixed fx0, Fixed fy0, Fixed fx1, Fixed fy1) {
+    bool ok = true;
+
+    std::vector<float> expected(2 * static_cast<size_t>(bresenhamLineCount(bx0, by0, bx1, by1)));
+    std::vector<float> actual(expected.size());
+    float* end = bresenhamLineDoubleStep(bx0, by0, bx1, by1, WIDTH, HEIGHT, actual.data());
+    bresenhamLine(bx0, by0, bx1, by1, WIDTH, HEIGHT, expected.data());
+    if (end != actual.data() + actual.size() || std::memcmp(expected.data(), actual.data(), expected.size() * sizeof(float)) != 0) {
+        std::cerr << "ERROR: bresenhamLineDoubleStep differs for (" << bx0 << ", " << by0 << ") - (" << bx1 << ", " << by1 << ")" << std::endl;
+        ok = false;
+    }
+
+    std::vector<PackedVertex> expectedWu(xiaolinWuLineFixedCount(fx0, fy0, fx1, fy1));
+    std::vector<PackedVertex> actualWu(expectedWu.size());
+    PackedVertex* wuEnd = xiaolinWuLineFixedTwoEnded(fx0, fy0, fx1, fy1, actualWu.data());
+    xiaolinWuLineFixed(fx0, fy0, fx1, fy1, expectedWu.data());
+    if (wuEnd != actualWu.data() + actualWu.size() || std::memcmp(expectedWu.data(), actualWu.data(), expectedWu.size() * sizeof(PackedVertex)) != 0) {
+        std::cerr << "ERROR: xiaolinWuLineFixedTwoEnded differs for (" << fx0 << ", " << fy0 << ") - (" << fx1 << ", " << fy1
+            << ") in 16.16" << std::endl;
+        ok = false;
+    }
+    return ok;
+}
+
+static bool verifyVariants() {
+    size_t lines = 0, failures = 0;
+    auto check = [&](const Line& l) {
+        int bx0 = static_cast<int>(std::round(l.x0)), by0 = static_cast<int>(std::round(l.y0));
+        int bx1 = static_cast<int>(std::round(l.x1)), by1 = static_cast<int>(std::round(l.y1));
+        ++lines;
+        if (!verifyLine(bx0, by0, bx1, by1, toFixed(l.x0), toFixed(l.y0), toFixed(l.x1), toFixed(l.y1)))
+            ++failures;
+    };
+
+    for (int length = 0; length <= 1024; length = length < 8 ? length + 1 : length * 2)
+        for (int octant = 0; octant < 8; ++octant)
+            for (int subpixel = 0; subpixel < 2; ++subpixel)
+                check(sweepLine(length, octant, subpixel != 0));
+
+    // Random lines, including ones far off screen, with a fixed seed so failures reproduce
+    std::mt19937 rng(27);
+    std::uniform_real_distribution<float> coord(-2000.0f, 4000.0f);
+    for (int i = 0; i < 100000; ++i)
+        check({ coord(rng), coord(rng), coord(rng), coord(rng) });
+
+    std::cerr << "verify: " << lines << " lines, " << failures << " differ" << std::endl;
+    return failures == 0;
+}
+
+// xiaolinWuLine at every SIMD level the CPU runs against the scalar loop, byte
+// for byte, in both output spaces
+static bool verifySimdLevels() {
+    const SimdLevel levels[] = { SimdLevel::SSE41, SimdLevel::AVX, SimdLevel::NEON };
+    const OutputSpace spaces[] = { OutputSpace::Ndc, OutputSpace::Pixels };
+    SimdLevel detected = getSimdLevel();
+
+    std::vector<Line> lines;
+    for (int length = 0; length <= 1024; length = length < 8 ? length + 1 : length * 2)
+        for (int octant = 0; octant < 8; ++octant)
+            for (int subpixel = 0; subpixel < 2; ++subpixel)
+                lines.push_back(sweepLine(length, octant, subpixel != 0));
+    std::mt19937 rng(6);
+    std::uniform_real_distribution<float> coord(-2000.0f, 4000.0f);
+    for (int i = 0; i < 40000; ++i)
+        lines.push_back({ coord(rng), coord(rng), coord(rng), coord(rng) });
+
+    size_t compared = 0, failures = 0;
+    std::vector<Vertex> expected, actual;
+    for (SimdLevel level : levels) {
+        if (!cpuSupports(level))
+            continue;
+        for (OutputSpace space : spaces) {
+            setOutputSpace(space);
+            for (const Line& l : lines) {
+                size_t count = xiaolinWuLineCount(l.x0, l.y0, l.x1, l.y1);
+                expected.resize(count);
+                actual.resize(count);
+                setSimdLevel(SimdLevel::Scalar);
+                xiaolinWuLine(l.x0, l.y0, l.x1, l.y1, WIDTH, HEIGHT, expected.data());
+                setSimdLevel(level);
+                Vertex* end = xiaolinWuLine(l.x0, l.y0, l.x1, l.y1, WIDTH, HEIGHT, actual.data());
+                ++compared;
+                if (end != actual.data() + count || std::memcmp(expected.data(), actual.data(), count * sizeof(Vertex)) != 0) {
+                    std::cerr << "ERROR: xiaolinWuLine at " << simdLevelName(level) << " differs from Scalar for (" << l.x0 << ", " << l.y0
+                        << ") - (" << l.x1 << ", " << l.y1 << ") in " << (space == OutputSpace::Pixels ? "pixel" : "NDC") << " space" << std::endl;
+                    ++failures;
+                }
+            }
+        }
+    }
+    setOutputSpace(OutputSpace::Ndc);
+    setSimdLevel(detected);
+
+    std::cerr << "verify: " << compared << " SIMD lines, " << failures << " differ" << std::endl;
+    return failures == 0;
+}
+
+// Coverage of every pixel a polyline covers, samples of the same pixel added up
+static std::map<std::pair<int, int>, float> polylineCoverage(std::span<const Point> points, FrameArena& arena) {
+    std::map<std::pair<int, int>, float> coverage;
+    arena.reset();
+    for (const PackedVertex& v : rasterizePolylinePacked(points, arena))
+        coverage[{ v.x, v.y }] += v.coverage / 255.0f;
+    return coverage;
+}
+
+// A straight line split at points on it must cover the same pixels as the
+// unsplit line with the same coverage: joints drawn twice show up here.
+// The tolerance allows the 8-bit coverage and the float drift of the main
+// loop, which adds up gradient per column and is off by up to 0.06 after
+// a thousand columns. A joint drawn twice is off by 0.3 or more.
+static bool verifyPolylines() {
+    const float TOLERANCE = 0.1f;
+    FrameArena arena;
+    size_t lines = 0, failures = 0;
+    auto check = [&](Point a, Point b, std::span<const float> splits) {
+        std::vector<Point> points = { a };
+        for (float t : splits)
+            points.push_back({ a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t });
+        points.push_back(b);
+        Point whole[2] = { a, b };
+
+        std::map<std::pair<int, int>, float> expected = polylineCoverage(whole, arena);
+        std::map<std::pair<int, int>, float> actual = polylineCoverage(points, arena);
+        float worst = 0.0f;
+        for (const auto& [pixel, alpha] : expected) {
+            auto it = actual.find(pixel);
+            worst = std::max(worst, std::abs(alpha - (it == actual.end() ? 0.0f : it->second)));
+        }
+        for (const auto& [pixel, alpha] : actual)
+            if (!expected.count(pixel)) worst = std::max(worst, alpha);
+
+        ++lines;
+        if (worst > TOLERANCE) {
+            std::cerr << "ERROR: polyline differs from its unsplit line by " << worst << " coverage for ("
+                << a.x << ", " << a.y << ") - (" << b.x << ", " << b.y << ") in " << points.size() - 1 << " segments" << std::endl;
+            ++failures;
+        }
+    };
+
+    // Joint at a fractional x, the case of almost every tessellated curve
+    const float split[] = { 0.5f };
+    check({ 10.0f, 10.3f }, { 100.0f, 40.7f }, split);
+
+    std::mt19937 rng(15);
+    std::uniform_real_distribution<float> coord(0.0f, float(WIDTH));
+    std::uniform_real_distribution<float> along(0.05f, 0.95f);
+    for (int i = 0; i < 5000; ++i) {
+        Point a = { coord(rng), coord(rng) }, b = { coord(rng), coord(rng) };
+        float splits[4];
+        int count = 1 + i % 4;
+        for (int k = 0; k < count; ++k) splits[k] = along(rng);
+        std::sort(splits, splits + count);
+        check(a, b, std::span<const float>(splits, count));
+    }
+
+    std::cerr << "verify: " << lines << " polylines, " << failures << " differ" << std::endl;
+    return failures == 0;
+}
+
+static void writeJson(std::ostream& os, const std::vector<Result>& results, double minTime) {
+    os << "{\n";
+    os << "  \"context\": {\n";
+    os << "    \"simd\": \"" << simdLevelName(getSimdLevel()) << "\",\n";
+    os << "    \"width\": " << WIDTH << ",\n";
+    os << "    \"height\": " << HEIGHT << ",\n";
+    os << "    \"repetitions\": " << REPETITIONS << ",\n";
+    os << "    \"min_time\": " << minTime << "\n";
+    os << "  },\n";
+    os << "  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        double nsPerPixel = r.pixelsPerCall > 0.0 ? r.nsPerCall / r.pixelsPerCall : 0.0;
+        double pixelsPerSecond = r.nsPerCall > 0.0 ? r.pixelsPerCall * 1e9 / r.nsPerCall : 0.0;
+        os << "    {";
+        os << "\"name\": \"" << jsonEscape(r.name) << "\", ";
+        os << "\"algorithm\": \"" << r.algorithm << "\", ";
+        if (r.length > 0) {
+            os << "\"length\": " << r.length << ", ";
+            os << "\"octant\": " << r.octant << ", ";
+            os << "\"steep\": " << (r.steep ? "true" : "false") << ", ";
+            os << "\"subpixel\": " << (r.subpixel ? "true" : "false") << ", ";
+        }
+        os << "\"iterations\": " << r.iterations << ", ";
+        os << "\"ns_per_call\": " << r.nsPerCall << ", ";
+        os << "\"pixels_per_call\": " << r.pixelsPerCall << ", ";
+        os << "\"ns_per_pixel\": " << nsPerPixel << ", ";
+        os << "\"pixels_per_second\": " << pixelsPerSecond << ", ";
+        os << "\"allocs_per_call\": " << r.allocsPerCall;
+        os << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n";
+    os << "}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string outPath;
+    std::string filter;
+    double minTime = 0.05;
+    bool verify = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--out" && i + 1 < argc) outPath = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc) minTime = std::atof(argv[++i]);
+        else if (arg == "--filter" && i + 1 < argc) filter = argv[++i];
+        else if (arg == "--verify") verify = true;
+        else {
+            std::cerr << "usage: " << argv[0] << " [--out results.json] [--min-time seconds] [--filter substring] [--verify]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (verify) {
+        bool ok = verifyVariants();
+        ok = verifySimdLevels() && ok;
+        ok = verifyPolylines() && ok;
+        return ok ? 0 : 1;
+    }
+
+    std::vector<Result> results;
+    // sweep carries the line parameters into the result (length 0 for non-line benchmarks)
+    Result sweep;
+    auto add = [&](const std::string& name, const std::string& algorithm, const std::function<size_t()>& body) {
+        if (!filter.empty() && name.find(filter) == std::string::npos)
+            return;
+        std::cerr << name << std::endl;
+        Result result = run(name, minTime, body);
+        result.algorithm = algorithm;
+        result.length = sweep.length;
+        result.octant = sweep.octant;
+        result.steep = sweep.steep;
+        result.subpixel = sweep.subpixel;
+        results.push_back(result);
+    };
+
+    // Output buffers are resized outside the timed calls, the pointer overloads don't allocate
+    std::vector<float> bresenhamOut;
+    std::vector<Vertex> wuOut;
+    std::vector<PackedVertex> wuPackedOut;
+    std::vector<PixelSpan> spansOut;
+
+    // SIMD levels timed next to the detected one
+    std::vector<SimdLevel> simdLevels;
+    for (SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE41, SimdLevel::AVX, SimdLevel::NEON })
+        if (level != detectSimdLevel() && cpuSupports(level))
+            simdLevels.push_back(level);
+
+    const int lengths[] = { 4, 16, 64, 256, 1024 };
+    for (int length : lengths) {
+        for (int octant = 0; octant < 8; ++octant) {
+            for (int subpixel = 0; subpixel < 2; ++subpixel) {
+                Line line = sweepLine(length, octant, subpixel != 0);
+                bool steep = std::abs(line.y1 - line.y0) > std::abs(line.x1 - line.x0);
+
+                int bx0 = static_cast<int>(std::round(line.x0)), by0 = static_cast<int>(std::round(line.y0));
+                int bx1 = static_cast<int>(std::round(line.x1)), by1 = static_cast<int>(std::round(line.y1));
+                bresenhamOut.resize(2 * static_cast<size_t>(bresenhamLineCount(bx0, by0, bx1, by1)));
+                spansOut.resize(bresenhamSpanCount(bx0, by0, bx1, by1));
+                int wuCount = xiaolinWuLineCount(line.x0, line.y0, line.x1, line.y1);
+                wuOut.resize(wuCount);
+                Fixed fx0 = toFixed(line.x0), fy0 = toFixed(line.y0), fx1 = toFixed(line.x1), fy1 = toFixed(line.y1);
+                wuPackedOut.resize(std::max(wuCount, xiaolinWuLineFixedCount(fx0, fy0, fx1, fy1)));
+
+                std::ostringstream suffix;
+                suffix << "/len:" << length << "/octant:" << octant << (subpixel ? "/subpixel" : "/integer");
+
+                sweep.length = length;
+                sweep.octant = octant;
+                sweep.steep = steep;
+                sweep.subpixel = subpixel != 0;
+
+                add("bresenhamLine" + suffix.str(), "bresenham", [&]() {
+                    float* end = bresenhamLine(bx0, by0, bx1, by1, WIDTH, HEIGHT, bresenhamOut.data());
+                    keep(end[-1]);
+                    return size_t(end - bresenhamOut.data()) / 2;
+                });
+                add("bresenhamLineDoubleStep" + suffix.str(), "bresenham_double_step", [&]() {
+                    float* end = bresenhamLineDoubleStep(bx0, by0, bx1, by1, WIDTH, HEIGHT, bresenhamOut.data());
+                    keep(end[-1]);
+                    return size_t(end - bresenhamOut.data()) / 2;
+                });
+                add("bresenhamSpans" + suffix.str(), "bresenham_spans", [&]() {
+                    PixelSpan* end = bresenhamSpans(bx0, by0, bx1, by1, spansOut.data());
+                    keep(float(end[-1].length));
+                    return size_t(bresenhamLineCount(bx0, by0, bx1, by1)); // pixels covered
+                });
+                add("bresenhamLine_vector" + suffix.str(), "bresenham", [&]() {
+                    std::vector<float> v = bresenhamLine(bx0, by0, bx1, by1, WIDTH, HEIGHT);
+                    keep(v.back());
+                    return v.size() / 2;
+                });
+                add("xiaolinWuLine" + suffix.str(), "wu", [&]() {
+                    Vertex* end = xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, WIDTH, HEIGHT, wuOut.data());
+                    keep(end[-1].alpha);
+                    return size_t(end - wuOut.data());
+                });
+                // The same line pinned to the scalar loop and every other level
+                // this CPU runs, the default one above is the detected level
+                for (SimdLevel level : simdLevels) {
+                    setSimdLevel(level);
+                    add("xiaolinWuLine_" + simdTag(level) + suffix.str(), "wu", [&]() {
+                        Vertex* end = xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, WIDTH, HEIGHT, wuOut.data());
+                        keep(end[-1].alpha);
+                        return size_t(end - wuOut.data());
+                    });
+                }
+                setSimdLevel(detectSimdLevel());
+                add("xiaolinWuLine_pixels" + suffix.str(), "wu", [&]() {
+                    setOutputSpace(OutputSpace::Pixels);
+                    Vertex* end = xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, WIDTH, HEIGHT, wuOut.data());
+                    setOutputSpace(OutputSpace::Ndc);
+                    keep(end[-1].alpha);
+                    return size_t(end - wuOut.data());
+                });
+                add("xiaolinWuLine_vector" + suffix.str(), "wu", [&]() {
+                    std::vector<Vertex> v = xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, WIDTH, HEIGHT);
+                    keep(v.back().alpha);
+                    return v.size();
+                });
+                add("xiaolinWuLinePacked" + suffix.str(), "wu_packed", [&]() {
+                    PackedVertex* end = xiaolinWuLinePacked(line.x0, line.y0, line.x1, line.y1, wuPackedOut.data());
+                    keep(end[-1].coverage);
+                    return size_t(end - wuPackedOut.data());
+                });
+                add("xiaolinWuLineFixed" + suffix.str(), "wu_fixed", [&]() {
+                    PackedVertex* end = xiaolinWuLineFixed(fx0, fy0, fx1, fy1, wuPackedOut.data());
+                    keep(end[-1].coverage);
+                    return size_t(end - wuPackedOut.data());
+                });
+                add("xiaolinWuLineFixedTwoEnded" + suffix.str(), "wu_fixed_two_ended", [&]() {
+                    PackedVertex* end = xiaolinWuLineFixedTwoEnded(fx0, fy0, fx1, fy1, wuPackedOut.data());
+                    keep(end[-1].coverage);
+                    return size_t(end - wuPackedOut.data());
+                });
+            }
+        }
+    }
+
+    sweep = Result();
+
+    // The demo's sine wave: 1280x720, one sample per column from x = 50 to 1230
+    SineWave wave = { 50, WIDTH - 50, 200.0f, 0.01f, 0.5f };
+    bresenhamOut.resize(2 * static_cast<size_t>(sineWaveCount(wave)));
+    wuOut.resize(2 * static_cast<size_t>(sineWaveCount(wave)));
+    wuPackedOut.resize(2 * static_cast<size_t>(sineWaveCount(wave)));
+
+    add("sineWaveBresenham", "bresenham", [&]() {
+        float* end = sineWaveBresenham(wave, WIDTH, HEIGHT, bresenhamOut.data());
+        keep(end[-1]);
+        return size_t(end - bresenhamOut.data()) / 2;
+    });
+    add("sineWaveWu", "wu", [&]() {
+        Vertex* end = sineWaveWu(wave, WIDTH, HEIGHT, wuOut.data());
+        keep(end[-1].alpha);
+        return size_t(end - wuOut.data());
+    });
+    add("sineWaveWuPacked", "wu_packed", [&]() {
+        PackedVertex* end = sineWaveWuPacked(wave, HEIGHT, wuPackedOut.data());
+        keep(end[-1].coverage);
+        return size_t(end - wuPackedOut.data());
+    });
+
+    // The demo's radial scene, lines only (pixels are the lines' endpoints)
+    add("generateLines_radial", "generate", [&]() {
+        std::vector<Line> lines = generateLines(WIDTH / 2, HEIGHT / 2, 800, 15);
+        keep(lines.back().x1);
+        return lines.size();
+    });
+
+    // M4 decimation of 4M samples onto the demo's 1181 columns, whole series and a 1% zoom
+    // (units are the samples each view covers)
+    std::vector<float> series(size_t(1) << 22);
+    std::mt19937 seriesRng(2);
+    std::normal_distribution<float> step(0.0f, 1.0f);
+    float walk = 0.0f;
+    for (float& v : series) v = walk += step(seriesRng);
+    SeriesPyramid pyramid;
+    pyramid.build(series);
+    std::vector<Point> decimated;
+    decimated.reserve(4 * WIDTH);
+
+    add("seriesDecimate_4M_full", "lod", [&]() {
+        pyramid.decimate(0, series.size(), 50, WIDTH - 50, HEIGHT / 2, 1.0f, decimated);
+        keep(decimated.back().y);
+        return series.size();
+    });
+    add("seriesDecimate_4M_zoom", "lod", [&]() {
+        size_t first = series.size() / 3, count = series.size() / 100;
+        pyramid.decimate(first, first + count, 50, WIDTH - 50, HEIGHT / 2, 1.0f, decimated);
+        keep(decimated.back().y);
+        return count;
+    });
+
+    // Long random lines into a 4K CPU framebuffer, one line at a time vs tile binned
+    const int FB_WIDTH = 3840, FB_HEIGHT = 2160;
+    std::vector<Line> randomLines(2000);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> randomX(-100.0f, FB_WIDTH + 100.0f), randomY(-100.0f, FB_HEIGHT + 100.0f);
+    for (Line& line : randomLines)
+        line = { randomX(rng), randomY(rng), randomX(rng), randomY(rng) };
+
+    // Visible pixels of the scene, what both variants produce
+    size_t bresenhamPixels = 0, wuPixels = 0;
+    for (const Line& line : randomLines) {
+        bresenhamPixels += bresenhamLineCountClipped(
+            static_cast<int>(std::round(line.x0)), static_cast<int>(std::round(line.y0)),
+            static_cast<int>(std::round(line.x1)), static_cast<int>(std::round(line.y1)), { 0, 0, FB_WIDTH, FB_HEIGHT });
+        Line clipped = line;
+        if (clipWuLine(clipped.x0, clipped.y0, clipped.x1, clipped.y1, { 0, 0, FB_WIDTH, FB_HEIGHT }))
+            wuPixels += xiaolinWuLineCount(clipped.x0, clipped.y0, clipped.x1, clipped.y1);
+    }
+
+    Framebuffer framebuffer(FB_WIDTH, FB_HEIGHT);
+    FrameArena arena;
+    add("framebuffer4k_bresenham_direct", "bresenham", [&]() {
+        for (const Line& line : randomLines)
+            bresenhamLine(static_cast<int>(std::round(line.x0)), static_cast<int>(std::round(line.y0)),
+                static_cast<int>(std::round(line.x1)), static_cast<int>(std::round(line.y1)), framebuffer, 1.0f, 0.0f, 1.0f);
+        keep(framebuffer.data()[0]);
+        return bresenhamPixels;
+    });
+    add("framebuffer4k_bresenham_tiled", "bresenham", [&]() {
+        arena.reset();
+        rasterizeLinesTiled(randomLines, RasterMode::Bresenham, framebuffer, arena);
+        keep(framebuffer.data()[0]);
+        return bresenhamPixels;
+    });
+    add("framebuffer4k_wu_direct", "wu", [&]() {
+        for (const Line& line : randomLines)
+            xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, framebuffer);
+        keep(framebuffer.data()[0]);
+        return wuPixels;
+    });
+    add("framebuffer4k_wu_tiled", "wu", [&]() {
+        arena.reset();
+        rasterizeLinesTiled(randomLines, RasterMode::Wu, framebuffer, arena);
+        keep(framebuffer.data()[0]);
+        return wuPixels;
+    });
+
+    if (outPath.empty()) {
+        writeJson(std::cout, results, minTime);
+    }
+    else {
+        std::ofstream file(outPath);
+        if (!file) {
+            std::cerr << "ERROR: could not open " << outPath << std::endl;
+            return 1;
+        }
+        writeJson(file, results, minTime);
+        std::cerr << "Wrote " << results.size() << " results to " << outPath << std::endl;
+    }
+    return 0;
+}
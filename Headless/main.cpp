@@ -0,0 +1,133 @@
+// Headless renderer
+// Draws the same 2x2 comparison as the demo window straight into a CPU
+// framebuffer and writes it to a PNG or PPM file. No GL context needed.
+//
+// usage: Headless <output.png|output.ppm> [sine|radial|<lines.wuln>] [width height] [phase]
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "Framebuffer.h"
+#include "LineFile.h"
+#include "Rasterizer.h"
+#include "TileRasterizer.h"
+
+// Viewport cell of the 2x2 comparison layout (pixels), same as the demo
+struct Cell {
+    int x, y, width, height;
+    float background[3];
+    float color[3];
+};
+
+// Sine wave, one sample per pixel column like the demo
+// Bresenham gets the nearest pixel, Wu splits each sample between two pixels
+static void drawSine(Framebuffer& target, bool wu, const float color[3], float phase) {
+    int width = target.viewportWidth();
+    int height = target.viewportHeight();
+
+    // The demo's sine is laid out for a 1280x720 window, scale it to the cell
+    float scale = height / 720.0f;
+    float amplitude = 200.0f * scale;
+    float frequency = 0.01f / scale;
+
+    int x_start = static_cast<int>(50 * scale);
+    int x_end = width - x_start;
+    for (int x = x_start; x <= x_end; ++x) {
+        float y = height / 2 + amplitude * sin(frequency * x + phase);
+
+        if (!wu) {
+            target.plot(x, static_cast<int>(std::floor(y + 0.5f)), color[0], color[1], color[2]);
+            continue;
+        }
+
+        // Wu: use floor + fractional part (dont round)
+        float y_floor = std::floor(y);
+        float frac = y - y_floor;
+        target.blend(x, static_cast<int>(y_floor), color[0], color[1], color[2], 1.0f - frac);
+        target.blend(x, static_cast<int>(y_floor) + 1, color[0], color[1], color[2], frac);
+    }
+}
+
+// Radial lines every 15 degrees from the cell center, drawn tile by tile
+static void drawRadial(Framebuffer& target, bool wu, const float color[3], FrameArena& arena) {
+    int width = target.viewportWidth();
+    int height = target.viewportHeight();
+    int radius = static_cast<int>(800 * (height / 720.0f));
+
+    std::span<Line> lines = generateLines(width / 2, height / 2, radius, 15, arena);
+    rasterizeLinesTiled(lines, wu ? RasterMode::Wu : RasterMode::Bresenham, target, arena,
+        color[0], color[1], color[2]);
+}
+
+// Lines of a memory-mapped line file, streamed window by window so a file
+// far bigger than memory draws with one window of lines alive at a time
+static void drawFile(Framebuffer& target, LineFile& file, bool wu, const float color[3], FrameArena& arena) {
+    ClipRect viewport = { -2, -2, target.viewportWidth() + 1, target.viewportHeight() + 1 };
+    streamLineFile(file, arena, [&](std::span<const Line> lines) {
+        rasterizeLinesTiled(lines, wu ? RasterMode::Wu : RasterMode::Bresenham, target, arena,
+            color[0], color[1], color[2]);
+    }, LINE_FILE_WINDOW, &viewport);
+}
+
+static bool endsWith(const std::string& s, const std::string& suffix) {
+    return s.size() >= suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <output.png|output.ppm> [sine|radial|<lines.wuln>] [width height] [phase]" << std::endl;
+        return 1;
+    }
+
+    std::string output = argv[1];
+    std::string curve = argc > 2 ? argv[2] : "radial";
+    int width = argc > 4 ? std::atoi(argv[3]) : 1280;
+    int height = argc > 4 ? std::atoi(argv[4]) : 720;
+    float phase = argc > 5 ? static_cast<float>(std::atof(argv[5])) : 0.0f;
+
+    bool fromFile = endsWith(curve, ".wuln");
+    if (width < 2 || height < 2 || (curve != "sine" && curve != "radial" && !fromFile)) {
+        std::cerr << "ERROR: invalid arguments" << std::endl;
+        return 1;
+    }
+
+    LineFile file;
+    if (fromFile && !file.open(curve))
+        return 1;
+
+    Framebuffer framebuffer(width, height);
+    FrameArena arena;
+
+    // Left: Bresenham, right: Wu, top: white background, bottom: black background
+    const Cell cells[4] = {
+        { 0,         height / 2, width / 2, height / 2, { 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f } },
+        { 0,         0,          width / 2, height / 2, { 0.0f, 0.0f, 0.0f }, { 1.0f, 1.0f, 0.0f } },
+        { width / 2, height / 2, width / 2, height / 2, { 1.0f, 1.0f, 1.0f }, { 1.0f, 0.0f, 1.0f } },
+        { width / 2, 0,          width / 2, height / 2, { 0.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 1.0f } },
+    };
+
+    for (int i = 0; i < 4; ++i) {
+        const Cell& cell = cells[i];
+        bool wu = i >= 2;
+
+        framebuffer.setViewport(cell.x, cell.y, cell.width, cell.height);
+        framebuffer.clear(cell.background[0], cell.background[1], cell.background[2]);
+
+        arena.reset();
+        if (curve == "sine") drawSine(framebuffer, wu, cell.color, phase);
+        else if (fromFile) drawFile(framebuffer, file, wu, cell.color, arena);
+        else drawRadial(framebuffer, wu, cell.color, arena);
+    }
+    framebuffer.resetViewport();
+
+    bool ok = endsWith(output, ".ppm") ? framebuffer.writePPM(output) : framebuffer.writePNG(output);
+    if (!ok) {
+        std::cerr << "ERROR: Could not write " << output << std::endl;
+        return 1;
+    }
+
+    std::cout << "Wrote " << output << " (" << width << "x" << height << ", " << curve << ")" << std::endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include "BatchRasterizer.h"
+
+#include <cmath>
+
+// Lines per chunk handed to a thread
+static const size_t LINE_GRAIN = 256;
+
+// Bresenham needs integer endpoints; round subpixel endpoints for it
+static int roundPixel(float v) {
+    return static_cast<int>(std::round(v));
+}
+
+// Wu lines are clipped in subpixel space, both stages must see the same result
+static bool clipWu(const Line& line, const ClipRect& rect, Line& clipped) {
+    clipped = line;
+    return clipWuLine(clipped.x0, clipped.y0, clipped.x1, clipped.y1, rect);
+}
+
+// Only pixels inside the render target are counted
+static size_t lineVertexCount(const Line& line, RasterMode mode, const ClipRect& rect) {
+    if (mode == RasterMode::Bresenham)
+        return bresenhamLineCountClipped(roundPixel(line.x0), roundPixel(line.y0), roundPixel(line.x1), roundPixel(line.y1), rect);
+    Line clipped;
+    if (!clipWu(line, rect, clipped))
+        return 0;
+    if (mode == RasterMode::WuFixed)
+        return xiaolinWuLineFixedCount(toFixed(clipped.x0), toFixed(clipped.y0), toFixed(clipped.x1), toFixed(clipped.y1));
+    return xiaolinWuLineCount(clipped.x0, clipped.y0, clipped.x1, clipped.y1);
+}
+
+RasterOutput rasterizeLines(std::span<const Line> lines, RasterMode mode,
+    int width, int height, FrameArena& arena,
+    float r, float g, float b, uint8_t colorIndex,
+    ThreadPool& pool) {
+    RasterOutput output;
+    if (lines.empty())
+        return output;
+
+    // Lines are clipped to the render target, off-screen pixels are never generated
+    const ClipRect rect{ 0, 0, width, height };
+
+    // Step 1 : Exact size of every line, in parallel
+    std::span<size_t> offsets = arena.allocate<size_t>(lines.size() + 1);
+    pool.parallelFor(lines.size(), LINE_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            offsets[i] = lineVertexCount(lines[i], mode, rect);
+    });
+
+    // Step 2 : Exclusive prefix sum gives each line its slice of the output
+    size_t total = 0;
+    for (size_t i = 0; i < lines.size(); ++i) {
+        size_t n = offsets[i];
+        offsets[i] = total;
+        total += n;
+    }
+    offsets[lines.size()] = total;
+    output.vertexCount = total;
+
+    // Step 3 : Rasterize straight into the slices, no two lines share memory
+    switch (mode) {
+    case RasterMode::Bresenham:
+        output.bresenham = arena.allocate<float>(2 * total);
+        pool.parallelFor(lines.size(), LINE_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const Line& line = lines[i];
+                bresenhamLineClipped(roundPixel(line.x0), roundPixel(line.y0), roundPixel(line.x1), roundPixel(line.y1),
+                    width, height, rect, output.bresenham.data() + 2 * offsets[i]);
+            }
+        });
+        break;
+    case RasterMode::Wu:
+        output.wu = arena.allocate<Vertex>(total);
+        pool.parallelFor(lines.size(), LINE_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Line line;
+                if (!clipWu(lines[i], rect, line))
+                    continue;
+                xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, width, height, output.wu.data() + offsets[i], r, g, b);
+            }
+        });
+        break;
+    case RasterMode::WuPacked:
+        output.wuPacked = arena.allocate<PackedVertex>(total);
+        pool.parallelFor(lines.size(), LINE_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Line line;
+                if (!clipWu(lines[i], rect, line))
+                    continue;
+                xiaolinWuLinePacked(line.x0, line.y0, line.x1, line.y1, output.wuPacked.data() + offsets[i], colorIndex);
+            }
+        });
+        break;
+    case RasterMode::WuFixed:
+        output.wuPacked = arena.allocate<PackedVertex>(total);
+        pool.parallelFor(lines.size(), LINE_GRAIN, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Line line;
+                if (!clipWu(lines[i], rect, line))
+                    continue;
+                xiaolinWuLineFixed(toFixed(line.x0), toFixed(line.y0), toFixed(line.x1), toFixed(line.y1),
+                    output.wuPacked.data() + offsets[i], colorIndex);
+            }
+        });
+        break;
+    }
+
+    return output;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "FrameArena.h"
+#include "Rasterizer.h"
+#include "ThreadPool.h"
+
+// Output format of a batch
+enum class RasterMode {
+    Bresenham, // float (x, y) pairs, endpoints rounded to pixels
+    Wu,        // Vertex
+    WuPacked,  // PackedVertex
+    WuFixed,   // PackedVertex from the 16.16 fixed-point kernel
+};
+
+// Result of rasterizeLines, allocated from the frame arena
+// Only the span matching the mode is filled, in line order (WuFixed fills wuPacked).
+struct RasterOutput {
+    std::span<float> bresenham;
+    std::span<Vertex> wu;
+    std::span<PackedVertex> wuPacked;
+    size_t vertexCount = 0;
+};
+
+// Rasterize a whole batch of lines
+// Each line's exact vertex count is prefix-summed first, then the lines are
+// rasterized in parallel into disjoint slices of one output buffer, so the
+// result is identical to rasterizing them one by one, whatever the thread count.
+// Every line is clipped to [0, width) x [0, height) first (see clipLine).
+RasterOutput rasterizeLines(std::span<const Line> lines, RasterMode mode,
+    int width, int height, FrameArena& arena,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f, uint8_t colorIndex = 0,
+    ThreadPool& pool = defaultThreadPool());
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Order-independent coverage accumulation for the Wu lines
+// Instead of blending every Wu pixel straight into the framebuffer (where
+// overlapping lines depend on draw order and darken each other), the lines
+// are drawn into an RGBA16F target: rgb adds up the premultiplied color
+// (color * coverage) and alpha the max (or sum) of the coverage. A second
+// R16F target adds up the coverage alone. One full-screen resolve pass
+// divides the two, the coverage-weighted mean color of every line on the
+// pixel, and blends it over the cells. Lines of different colors then mix
+// the same way in any order, and a faint fringe of one line can't change
+// the color of another.
+//
+// The weight comes from the fragment shader's second output, vec4(1, 0, 0,
+// coverage), which only the coverage target has a draw buffer for.
+class CoverageBuffer {
+public:
+    enum class Mode {
+        Max,      // coverage = max over lines, the union of the lines
+        Additive, // coverage = sum over lines, clamped at resolve
+    };
+
+    // program: linked resolve_vertex_shader.glsl + resolve_fragment_shader.glsl
+    void init(GLuint program, int width, int height);
+    void destroy();
+
+    // Reallocate the target for a new framebuffer size
+    void resize(int width, int height);
+
+    // Redirect drawing into the cleared accumulation target
+    void begin(Mode mode);
+
+    // Back to the framebuffer that was bound at begin() with normal blending state
+    void end();
+
+    // Blend the accumulated coverage over the bound framebuffer
+    // Clip distances must be disabled, the resolve shader doesn't write them
+    void resolve();
+
+private:
+    GLuint shaderProgram = 0;
+    GLuint fbo = 0;
+    GLuint texture = 0;       // RGBA16F, premultiplied color and coverage
+    GLuint weightTexture = 0; // R16F, summed coverage
+    GLuint vao = 0; // empty, core profile needs one bound to draw
+    GLint previousFbo = 0;
+    int targetWidth = 0, targetHeight = 0;
+};
@@ -0,0 +1,28 @@
+#include "DamageTracker.h"
+
+#include <algorithm>
+
+ClipRect unite(const ClipRect& a, const ClipRect& b) {
+    if (isEmpty(a)) return b;
+    if (isEmpty(b)) return a;
+    return { std::min(a.x0, b.x0), std::min(a.y0, b.y0), std::max(a.x1, b.x1), std::max(a.y1, b.y1) };
+}
+
+ClipRect intersect(const ClipRect& a, const ClipRect& b) {
+    return { std::max(a.x0, b.x0), std::max(a.y0, b.y0), std::min(a.x1, b.x1), std::min(a.y1, b.y1) };
+}
+
+void DamageTracker::invalidate(const ClipRect& bounds) {
+    forced = unite(forced, bounds);
+}
+
+void DamageTracker::add(const ClipRect& bounds) {
+    current = unite(current, bounds);
+}
+
+ClipRect DamageTracker::endFrame() {
+    ClipRect damage = unite(unite(previous, current), forced);
+    previous = current;
+    current = forced = { 0, 0, 0, 0 };
+    return damage;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Rasterizer.h"
+
+// ---------- Damage tracking ----------
+// Only the part of the screen where something changed is cleared and redrawn,
+// everything else is kept from earlier frames (see SceneTarget). Content
+// that moves adds its bounds every frame; the region to redraw is where it
+// is now plus where it was last frame, so its old pixels get erased too.
+// Static content adds nothing and is only redrawn through invalidate().
+
+// [x0, x1) x [y0, y1) with nothing in it
+inline bool isEmpty(const ClipRect& r) { return r.x0 >= r.x1 || r.y0 >= r.y1; }
+
+// Smallest rectangle holding both, empty rectangles are ignored
+ClipRect unite(const ClipRect& a, const ClipRect& b);
+
+ClipRect intersect(const ClipRect& a, const ClipRect& b);
+
+class DamageTracker {
+public:
+    // Redraw all of bounds on the next frame (first frame, mode switches)
+    void invalidate(const ClipRect& bounds);
+
+    // This frame's bounds of content that moves or changes
+    void add(const ClipRect& bounds);
+
+    // Region to clear and redraw this frame, empty if nothing changed
+    // Starts the next frame.
+    ClipRect endFrame();
+
+private:
+    ClipRect previous = { 0, 0, 0, 0 };
+    ClipRect current = { 0, 0, 0, 0 };
+    ClipRect forced = { 0, 0, 0, 0 };
+};
@@ -0,0 +1,60 @@
+#include "FrameArena.h"
+
+#include <cstdint>
+
+// Round value up to a multiple of alignment (a power of two)
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+FrameArena::FrameArena(size_t initialBytes) {
+    blockSize = initialBytes;
+    block = static_cast<unsigned char*>(::operator new(blockSize));
+}
+
+FrameArena::~FrameArena() {
+    for (unsigned char* chunk : overflow)
+        ::operator delete(chunk);
+    ::operator delete(block);
+}
+
+void FrameArena::reset() {
+    if (!overflow.empty()) {
+        // Last frame didn't fit: replace the overflow chunks with one block
+        // big enough for the high-water mark (plus some headroom)
+        for (unsigned char* chunk : overflow)
+            ::operator delete(chunk);
+        overflow.clear();
+
+        ::operator delete(block);
+        blockSize = alignUp(peakBytes + peakBytes / 4, 4096);
+        block = static_cast<unsigned char*>(::operator new(blockSize));
+    }
+    offset = 0;
+    overflowBytes = 0;
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(block);
+    size_t start = alignUp(base + offset, alignment) - base;
+
+    void* ptr;
+    if (start + bytes <= blockSize) {
+        ptr = block + start;
+        offset = start + bytes;
+    }
+    else {
+        // Serve from a dedicated chunk, operator new is aligned to max_align_t
+        size_t chunkBytes = bytes + alignment;
+        unsigned char* chunk = static_cast<unsigned char*>(::operator new(chunkBytes));
+        overflow.push_back(chunk);
+        overflowBytes += chunkBytes;
+
+        uintptr_t chunkBase = reinterpret_cast<uintptr_t>(chunk);
+        ptr = chunk + (alignUp(chunkBase, alignment) - chunkBase);
+    }
+
+    if (used() > peakBytes)
+        peakBytes = used();
+    return ptr;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+// Linear per-frame allocator
+// Everything allocated during a frame is released at once by reset().
+// The arena keeps its high-water mark: if a frame overflows the main block,
+// the overflow is served from extra chunks and the next reset() grows the
+// main block to the peak, so steady-state frames never touch the heap.
+class FrameArena {
+public:
+    explicit FrameArena(size_t initialBytes = 1 << 20);
+    ~FrameArena();
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // Start a new frame, invalidating all previous allocations
+    void reset();
+
+    void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+
+    // Uninitialized storage for count objects of a trivial type
+    template <typename T>
+    std::span<T> allocate(size_t count) {
+        static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>,
+            "FrameArena only holds trivial types, nothing is destroyed on reset()");
+        if (count == 0)
+            return {};
+        return { static_cast<T*>(allocate(count * sizeof(T), alignof(T))), count };
+    }
+
+    size_t used() const { return offset + overflowBytes; } // bytes allocated this frame
+    size_t peak() const { return peakBytes; }                // largest used() seen so far
+    size_t capacity() const { return blockSize; }            // main block size
+
+private:
+    unsigned char* block = nullptr;
+    size_t blockSize = 0;
+    size_t offset = 0;
+
+    std::vector<unsigned char*> overflow;
+    size_t overflowBytes = 0;
+
+    size_t peakBytes = 0;
+};
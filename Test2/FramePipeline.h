@@ -0,0 +1,142 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+#include "FrameArena.h"
+
+// Frame generation pipelined with rendering
+// A worker thread generates the geometry of the next frames while the
+// render loop uploads and draws the current one, so CPU generation and GPU
+// drawing overlap instead of taking turns. Every frame in flight has its own
+// slot, a FrameArena and a Frame generated into it, so the worker never
+// writes memory the render loop is reading.
+//
+// depth is how many frames are generated ahead of the one being drawn,
+// which is also the added latency in frames. Depth 0 generates on the
+// calling thread in acquire(), exactly like no pipeline at all.
+//
+// The generator is fixed at construction and every submitted frame only
+// copies its Params into the slot, so queueing a frame never allocates.
+//
+// All members are called from the render loop thread.
+template <typename Frame, typename Params>
+class FramePipeline {
+public:
+    using Generate = std::function<void(const Params&, Frame&, FrameArena&)>;
+
+    static const int MAX_DEPTH = 3;
+
+    explicit FramePipeline(Generate generate)
+        : generate(std::move(generate)), worker(&FramePipeline::workerLoop, this) {}
+
+    ~FramePipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    FramePipeline(const FramePipeline&) = delete;
+    FramePipeline& operator=(const FramePipeline&) = delete;
+
+    // Drops the frames in flight, clamped to [0, MAX_DEPTH]
+    void setDepth(int depth) {
+        flush();
+        std::lock_guard<std::mutex> lock(mutex);
+        ahead = depth < 0 ? 0 : (depth > MAX_DEPTH ? MAX_DEPTH : depth);
+    }
+
+    int depth() const { return ahead; }
+
+    // Frames submitted and not released yet, at most depth() + 1
+    int inFlight() const { return static_cast<int>(submitted - released); }
+
+    // Queue the next frame, generated from params in submission order
+    void submit(const Params& params) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            slots[submitted % SLOT_COUNT].params = params;
+            ++submitted;
+        }
+        wake.notify_one();
+    }
+
+    // Oldest frame in flight, waits until it is generated
+    // It stays valid and untouched until release().
+    Frame& acquire() {
+        Slot& slot = slots[released % SLOT_COUNT];
+        std::unique_lock<std::mutex> lock(mutex);
+        if (ahead == 0 && generated == released) {
+            lock.unlock();
+            slot.arena.reset();
+            generate(slot.params, slot.frame, slot.arena);
+            lock.lock();
+            ++generated;
+        }
+        done.wait(lock, [&] { return generated > released; });
+        return slot.frame;
+    }
+
+    void release() { ++released; }
+
+    // Wait for the worker and drop every frame in flight (none may be acquired)
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (ahead == 0)
+            generated = submitted; // nothing runs on the worker, frames not acquired yet are just dropped
+        done.wait(lock, [&] { return generated == submitted; });
+        released = submitted;
+    }
+
+private:
+    static const int SLOT_COUNT = MAX_DEPTH + 1; // frames ahead plus the one being drawn
+
+    struct Slot {
+        FrameArena arena;
+        Frame frame;
+        Params params;
+    };
+
+    void workerLoop() {
+        while (true) {
+            Slot* slot;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return stopping || (ahead > 0 && generated < submitted); });
+                if (stopping)
+                    return;
+                slot = &slots[generated % SLOT_COUNT];
+            }
+
+            slot->arena.reset();
+            generate(slot->params, slot->frame, slot->arena);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++generated;
+            }
+            done.notify_all();
+        }
+    }
+
+    Generate generate;
+    Slot slots[SLOT_COUNT];
+
+    // Frame counters, a frame's slot is its number modulo SLOT_COUNT
+    unsigned long long submitted = 0;
+    unsigned long long generated = 0;
+    unsigned long long released = 0; // render loop only
+    int ahead = 0;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    bool stopping = false;
+
+    std::thread worker; // last, starts once everything above is constructed
+};
@@ -0,0 +1,160 @@
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+void FrameProfiler::Samples::push(double v) {
+    if (static_cast<int>(values.size()) < WINDOW) {
+        values.push_back(v);
+        return;
+    }
+    values[next] = v;
+    next = (next + 1) % WINDOW;
+}
+
+double FrameProfiler::Samples::percentile(double p) const {
+    if (values.empty())
+        return 0.0;
+    // WINDOW is small, sorting a copy is cheaper than keeping an order statistic tree
+    std::vector<double> sorted = values;
+    size_t index = static_cast<size_t>(p * (sorted.size() - 1) + 0.5);
+    std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+    return sorted[index];
+}
+
+void FrameProfiler::init(const std::vector<std::string>& scopeNames) {
+    scopes.resize(scopeNames.size());
+    for (size_t i = 0; i < scopes.size(); ++i) {
+        scopes[i].name = scopeNames[i];
+        glGenQueries(2 * LATENCY, &scopes[i].queries[0][0]);
+    }
+    slot = 0;
+    frameIndex = 0;
+}
+
+void FrameProfiler::destroy() {
+    stopCsv();
+    for (Scope& scope : scopes)
+        glDeleteQueries(2 * LATENCY, &scope.queries[0][0]);
+    scopes.clear();
+}
+
+void FrameProfiler::beginFrame() {
+    slot = static_cast<int>(frameIndex % LATENCY);
+    // The queries in this slot were issued LATENCY frames ago, read them before reuse
+    collect(slot);
+    for (Scope& scope : scopes)
+        scope.cpuMs = 0.0;
+}
+
+void FrameProfiler::endFrame(float frameSeconds) {
+    frame.push(frameSeconds * 1000.0);
+    for (Scope& scope : scopes)
+        scope.cpu.push(scope.cpuMs);
+    if (csv.is_open())
+        writeCsvRow(frameSeconds);
+    ++frameIndex;
+}
+
+void FrameProfiler::begin(int scope) {
+    Scope& s = scopes[scope];
+    glQueryCounter(s.queries[slot][0], GL_TIMESTAMP);
+    s.cpuStart = Clock::now();
+}
+
+void FrameProfiler::end(int scope) {
+    Scope& s = scopes[scope];
+    s.cpuMs += std::chrono::duration<double, std::milli>(Clock::now() - s.cpuStart).count();
+    glQueryCounter(s.queries[slot][1], GL_TIMESTAMP);
+    s.issued[slot] = true;
+}
+
+void FrameProfiler::collect(int index) {
+    for (Scope& scope : scopes) {
+        if (!scope.issued[index])
+            continue;
+        scope.issued[index] = false;
+
+        // After LATENCY frames the result is almost always there, if not it's
+        // not worth stalling for, drop the sample
+        GLint available = 0;
+        glGetQueryObjectiv(scope.queries[index][1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            continue;
+
+        GLuint64 start = 0, stop = 0;
+        glGetQueryObjectui64v(scope.queries[index][0], GL_QUERY_RESULT, &start);
+        glGetQueryObjectui64v(scope.queries[index][1], GL_QUERY_RESULT, &stop);
+        scope.lastGpuMs = stop > start ? (stop - start) / 1.0e6 : 0.0;
+        scope.gpu.push(scope.lastGpuMs);
+    }
+}
+
+double FrameProfiler::cpuPercentile(int scope, double p) const {
+    return scopes[scope].cpu.percentile(p);
+}
+
+double FrameProfiler::gpuPercentile(int scope, double p) const {
+    return scopes[scope].gpu.percentile(p);
+}
+
+double FrameProfiler::framePercentile(double p) const {
+    return frame.percentile(p);
+}
+
+std::string FrameProfiler::summary() const {
+    std::string out;
+    char line[160];
+    std::snprintf(line, sizeof(line), "frame      %7.3f / %7.3f ms (p50 / p99)\n",
+        framePercentile(0.5), framePercentile(0.99));
+    out += line;
+    for (size_t i = 0; i < scopes.size(); ++i) {
+        std::snprintf(line, sizeof(line), "%-10s cpu %7.3f / %7.3f ms   gpu %7.3f / %7.3f ms\n",
+            scopes[i].name.c_str(),
+            cpuPercentile(static_cast<int>(i), 0.5), cpuPercentile(static_cast<int>(i), 0.99),
+            gpuPercentile(static_cast<int>(i), 0.5), gpuPercentile(static_cast<int>(i), 0.99));
+        out += line;
+    }
+    return out;
+}
+
+std::string FrameProfiler::titleSummary() const {
+    std::string out;
+    char part[96];
+    std::snprintf(part, sizeof(part), "frame %.2f/%.2f ms", framePercentile(0.5), framePercentile(0.99));
+    out += part;
+    for (size_t i = 0; i < scopes.size(); ++i) {
+        std::snprintf(part, sizeof(part), " | %s cpu %.2f gpu %.2f", scopes[i].name.c_str(),
+            cpuPercentile(static_cast<int>(i), 0.5), gpuPercentile(static_cast<int>(i), 0.5));
+        out += part;
+    }
+    return out;
+}
+
+bool FrameProfiler::startCsv(const std::string& path) {
+    stopCsv();
+    csv.open(path);
+    if (!csv.is_open()) {
+        std::cerr << "ERROR: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+    csv << "frame,frame_ms";
+    for (const Scope& scope : scopes)
+        csv << "," << scope.name << "_cpu_ms," << scope.name << "_gpu_ms";
+    csv << "\n";
+    return true;
+}
+
+void FrameProfiler::stopCsv() {
+    if (csv.is_open())
+        csv.close();
+}
+
+void FrameProfiler::writeCsvRow(float frameSeconds) {
+    // GPU columns hold the latest result read back, which is LATENCY frames old
+    csv << frameIndex << "," << frameSeconds * 1000.0;
+    for (const Scope& scope : scopes)
+        csv << "," << scope.cpuMs << "," << scope.lastGpuMs;
+    csv << "\n";
+}
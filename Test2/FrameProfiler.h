@@ -0,0 +1,78 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// CPU and GPU timing of the render loop
+// A frame is split into named scopes. CPU scopes are timed with steady_clock,
+// GPU scopes with a pair of glQueryCounter timestamps (GL 3.3 / ARB_timer_query).
+// Timestamps are read back LATENCY frames later, so the CPU never waits for them.
+//
+// Every scope keeps the last WINDOW samples of each side and reports
+// rolling p50 / p99. Optionally every frame is appended to a CSV file.
+class FrameProfiler {
+public:
+    static const int LATENCY = 4;   // frames between issuing a GPU query and reading it
+    static const int WINDOW = 240;  // samples kept per scope for the percentiles
+
+    // Scopes are fixed up front, the index is what begin/end take
+    void init(const std::vector<std::string>& scopeNames);
+    void destroy();
+
+    void beginFrame();
+    void endFrame(float frameSeconds);
+
+    // Time the CPU work and the GPU commands between begin and end
+    void begin(int scope);
+    void end(int scope);
+
+    // Rolling percentiles in milliseconds (0 when there are no samples yet)
+    double cpuPercentile(int scope, double p) const;
+    double gpuPercentile(int scope, double p) const;
+    double framePercentile(double p) const;
+
+    // One line per scope: "name cpu p50/p99 gpu p50/p99"
+    std::string summary() const;
+
+    // Short form for the window title
+    std::string titleSummary() const;
+
+    // Append one row per frame to path (frame, frame_ms, then cpu/gpu ms per scope)
+    bool startCsv(const std::string& path);
+    void stopCsv();
+    bool isRecording() const { return csv.is_open(); }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Samples {
+        std::vector<double> values; // ring of WINDOW samples
+        int next = 0;
+
+        void push(double v);
+        double percentile(double p) const;
+    };
+
+    struct Scope {
+        std::string name;
+        Clock::time_point cpuStart;
+        double cpuMs = 0.0;   // this frame
+        Samples cpu, gpu;
+        GLuint queries[LATENCY][2] = {}; // begin/end timestamps per frame slot
+        bool issued[LATENCY] = {};
+        double lastGpuMs = 0.0;
+    };
+
+    void collect(int slot);
+    void writeCsvRow(float frameSeconds);
+
+    std::vector<Scope> scopes;
+    Samples frame;
+    int slot = 0;
+    long long frameIndex = 0;
+    std::ofstream csv;
+};
@@ -0,0 +1,203 @@
+#include "Framebuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+static uint8_t toByte(float v) {
+    if (v <= 0.0f) return 0;
+    if (v >= 1.0f) return 255;
+    return static_cast<uint8_t>(v * 255.0f + 0.5f);
+}
+
+Framebuffer::Framebuffer(int width, int height)
+    : fbWidth(width), fbHeight(height), pixels(static_cast<size_t>(width) * height * 4, 0) {
+    resetViewport();
+}
+
+void Framebuffer::setViewport(int x, int y, int width, int height) {
+    vpX = x;
+    vpY = y;
+    vpWidth = width;
+    vpHeight = height;
+}
+
+uint8_t* Framebuffer::pixel(int x, int y) {
+    if (x < 0 || y < 0 || x >= vpWidth || y >= vpHeight)
+        return nullptr;
+    x += vpX;
+    y += vpY;
+    if (x < 0 || y < 0 || x >= fbWidth || y >= fbHeight)
+        return nullptr;
+    return &pixels[(static_cast<size_t>(y) * fbWidth + x) * 4];
+}
+
+void Framebuffer::clear(float r, float g, float b, float a) {
+    uint8_t color[4] = { toByte(r), toByte(g), toByte(b), toByte(a) };
+    for (int y = 0; y < vpHeight; ++y) {
+        for (int x = 0; x < vpWidth; ++x) {
+            uint8_t* p = pixel(x, y);
+            if (!p) continue;
+            p[0] = color[0]; p[1] = color[1]; p[2] = color[2]; p[3] = color[3];
+        }
+    }
+}
+
+void Framebuffer::plot(int x, int y, float r, float g, float b) {
+    uint8_t* p = pixel(x, y);
+    if (!p) return;
+    p[0] = toByte(r);
+    p[1] = toByte(g);
+    p[2] = toByte(b);
+    p[3] = 255;
+}
+
+void Framebuffer::fillSpan(int x, int y, int length, bool vertical, float r, float g, float b) {
+    // Clip the run to the viewport and the framebuffer once
+    int& start = vertical ? y : x;
+    int lo = vertical ? std::max(0, -vpY) : std::max(0, -vpX);
+    int hi = vertical ? std::min(vpHeight, fbHeight - vpY) : std::min(vpWidth, fbWidth - vpX);
+    int end = std::min(start + length, hi);
+    start = std::max(start, lo);
+    if (start >= end)
+        return;
+    length = end - start;
+
+    uint8_t* p = pixel(x, y);
+    if (!p) return; // the other axis is outside
+
+    const uint8_t color[4] = { toByte(r), toByte(g), toByte(b), 255 };
+    size_t stride = vertical ? static_cast<size_t>(fbWidth) * 4 : 4;
+    for (int i = 0; i < length; ++i, p += stride)
+        std::memcpy(p, color, 4);
+}
+
+void Framebuffer::blend(int x, int y, float r, float g, float b, float alpha) {
+    uint8_t* p = pixel(x, y);
+    if (!p) return;
+
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    float inv = 1.0f - alpha;
+
+    p[0] = toByte(r * alpha + (p[0] / 255.0f) * inv);
+    p[1] = toByte(g * alpha + (p[1] / 255.0f) * inv);
+    p[2] = toByte(b * alpha + (p[2] / 255.0f) * inv);
+    p[3] = toByte(alpha + (p[3] / 255.0f) * inv);
+}
+
+bool Framebuffer::writePPM(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open image file: " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << fbWidth << " " << fbHeight << "\n255\n";
+    std::vector<char> row(static_cast<size_t>(fbWidth) * 3);
+    for (int y = fbHeight - 1; y >= 0; --y) {
+        const uint8_t* src = &pixels[static_cast<size_t>(y) * fbWidth * 4];
+        for (int x = 0; x < fbWidth; ++x) {
+            row[x * 3 + 0] = static_cast<char>(src[x * 4 + 0]);
+            row[x * 3 + 1] = static_cast<char>(src[x * 4 + 1]);
+            row[x * 3 + 2] = static_cast<char>(src[x * 4 + 2]);
+        }
+        file.write(row.data(), row.size());
+    }
+    return file.good();
+}
+
+// ---------- PNG ----------
+// Minimal writer: RGBA8, no filtering, zlib stream made of stored (uncompressed)
+// deflate blocks. Bigger files than a real encoder but no dependencies.
+
+static uint32_t crc32(const uint8_t* data, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool built = false;
+    if (!built) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[i] = c;
+        }
+        built = true;
+    }
+    crc = ~crc;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static void putU32(std::vector<uint8_t>& out, uint32_t v) {
+    out.push_back(static_cast<uint8_t>(v >> 24));
+    out.push_back(static_cast<uint8_t>(v >> 16));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+static void writeChunk(std::ofstream& file, const char* type, const std::vector<uint8_t>& payload) {
+    std::vector<uint8_t> chunk;
+    putU32(chunk, static_cast<uint32_t>(payload.size()));
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), payload.begin(), payload.end());
+    putU32(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    file.write(reinterpret_cast<const char*>(chunk.data()), chunk.size());
+}
+
+bool Framebuffer::writePNG(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "ERROR: Could not open image file: " << path << std::endl;
+        return false;
+    }
+
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    file.write(reinterpret_cast<const char*>(signature), sizeof(signature));
+
+    std::vector<uint8_t> header;
+    putU32(header, static_cast<uint32_t>(fbWidth));
+    putU32(header, static_cast<uint32_t>(fbHeight));
+    header.push_back(8); // bit depth
+    header.push_back(6); // RGBA
+    header.push_back(0); // deflate
+    header.push_back(0); // adaptive filtering (we only use filter type 0)
+    header.push_back(0); // no interlace
+    writeChunk(file, "IHDR", header);
+
+    // Raw scanlines, top row first, each prefixed with filter type 0
+    size_t rowBytes = static_cast<size_t>(fbWidth) * 4;
+    std::vector<uint8_t> raw;
+    raw.reserve((rowBytes + 1) * fbHeight);
+    for (int y = fbHeight - 1; y >= 0; --y) {
+        raw.push_back(0);
+        const uint8_t* src = &pixels[static_cast<size_t>(y) * rowBytes];
+        raw.insert(raw.end(), src, src + rowBytes);
+    }
+
+    // zlib stream with stored blocks of at most 65535 bytes
+    std::vector<uint8_t> zlib = { 0x78, 0x01 };
+    uint32_t a = 1, b = 0; // Adler-32
+    for (size_t pos = 0; pos < raw.size() || raw.empty(); ) {
+        size_t n = raw.size() - pos < 65535 ? raw.size() - pos : 65535;
+        bool last = (pos + n == raw.size());
+        zlib.push_back(last ? 1 : 0);
+        zlib.push_back(static_cast<uint8_t>(n));
+        zlib.push_back(static_cast<uint8_t>(n >> 8));
+        zlib.push_back(static_cast<uint8_t>(~n));
+        zlib.push_back(static_cast<uint8_t>(~n >> 8));
+        for (size_t i = pos; i < pos + n; ++i) {
+            a = (a + raw[i]) % 65521;
+            b = (b + a) % 65521;
+        }
+        zlib.insert(zlib.end(), raw.begin() + pos, raw.begin() + pos + n);
+        pos += n;
+        if (last) break;
+    }
+    putU32(zlib, (b << 16) | a);
+    writeChunk(file, "IDAT", zlib);
+    writeChunk(file, "IEND", {});
+
+    return file.good();
+}
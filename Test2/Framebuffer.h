@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// CPU raster target for headless rendering
+// Tight RGBA8 pixels, row 0 at the bottom like a GL framebuffer.
+// A viewport works like glViewport + glScissor: plot coordinates are
+// relative to it and anything outside it is dropped.
+class Framebuffer {
+public:
+    Framebuffer(int width, int height);
+
+    int width() const { return fbWidth; }
+    int height() const { return fbHeight; }
+
+    uint8_t* data() { return pixels.data(); }
+    const uint8_t* data() const { return pixels.data(); }
+
+    void setViewport(int x, int y, int width, int height);
+    void resetViewport() { setViewport(0, 0, fbWidth, fbHeight); }
+    int viewportWidth() const { return vpWidth; }
+    int viewportHeight() const { return vpHeight; }
+
+    // Fill the viewport
+    void clear(float r, float g, float b, float a = 1.0f);
+
+    // Opaque pixel
+    void plot(int x, int y, float r, float g, float b);
+
+    // Opaque run of length pixels from (x, y) along x, or along y if vertical
+    // Same as plotting them one by one, a row run is one contiguous fill
+    void fillSpan(int x, int y, int length, bool vertical, float r, float g, float b);
+
+    // Alpha blended pixel, same as glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA)
+    // alpha is clamped to [0, 1] like a fixed-point color buffer would
+    void blend(int x, int y, float r, float g, float b, float alpha);
+
+    // Image files are written top row first
+    bool writePPM(const std::string& path) const;
+    bool writePNG(const std::string& path) const;
+
+private:
+    uint8_t* pixel(int x, int y);
+
+    int fbWidth, fbHeight;
+    int vpX = 0, vpY = 0, vpWidth = 0, vpHeight = 0;
+    std::vector<uint8_t> pixels;
+};
@@ -0,0 +1,46 @@
+#include "GeometryCache.h"
+#include "BatchRasterizer.h"
+
+void RadialGeometryCache::init() {
+    glGenBuffers(1, &bresenhamVbo);
+    glGenBuffers(1, &wuVbo);
+    valid = false;
+}
+
+void RadialGeometryCache::destroy() {
+    glDeleteBuffers(1, &bresenhamVbo);
+    glDeleteBuffers(1, &wuVbo);
+    bresenhamVbo = 0;
+    wuVbo = 0;
+    valid = false;
+}
+
+bool RadialGeometryCache::update(const RadialParams& params, FrameArena& arena) {
+    if (valid && params == cached)
+        return false;
+
+    auto lines = generateLines(params.centerX, params.centerY, params.radius, params.angleStep, arena);
+
+    RasterOutput bresenham = rasterizeLines(lines, RasterMode::Bresenham, params.width, params.height, arena);
+    RasterMode wuMode = !params.packed ? RasterMode::Wu : params.fixedPoint ? RasterMode::WuFixed : RasterMode::WuPacked;
+    RasterOutput wu = rasterizeLines(lines, wuMode,
+        params.width, params.height, arena, 1.0f, 0.0f, 1.0f, 0);
+
+    // Static draw: written once here, read by every following frame
+    glBindBuffer(GL_ARRAY_BUFFER, bresenhamVbo);
+    glBufferData(GL_ARRAY_BUFFER, bresenham.bresenham.size_bytes(), bresenham.bresenham.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ARRAY_BUFFER, wuVbo);
+    if (params.packed)
+        glBufferData(GL_ARRAY_BUFFER, wu.wuPacked.size_bytes(), wu.wuPacked.data(), GL_STATIC_DRAW);
+    else
+        glBufferData(GL_ARRAY_BUFFER, wu.wu.size_bytes(), wu.wu.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    bresenhamVertices = static_cast<GLsizei>(bresenham.bresenham.size() / 2);
+    wuVertices = static_cast<GLsizei>(wu.vertexCount);
+
+    cached = params;
+    valid = true;
+    return true;
+}
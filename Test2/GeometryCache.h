@@ -0,0 +1,55 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "FrameArena.h"
+#include "Rasterizer.h"
+
+// Inputs of the radial line scene, the cache key
+struct RadialParams {
+    int centerX, centerY;
+    int radius;
+    int angleStep;
+    int width, height; // render target the NDC vertices are computed for
+    bool packed;       // Wu vertices as PackedVertex instead of Vertex
+    bool fixedPoint;   // packed Wu from the 16.16 fixed-point kernel
+    bool pixelSpace;   // float vertices in pixels (OutputSpace::Pixels) instead of NDC
+
+    bool operator==(const RadialParams&) const = default;
+};
+
+// Rasterized radial lines kept resident on the GPU
+// The scene is static, so it is only generated, rasterized and uploaded
+// when one of its parameters changes. Every other frame costs just the draws.
+//
+// The buffer names never change, only their storage, so VAOs set up
+// once on bresenhamBuffer() / wuBuffer() stay valid across rebuilds.
+class RadialGeometryCache {
+public:
+    void init();
+    void destroy();
+
+    // Rebuild if params differ from the cached scene
+    // arena is only used as scratch while rebuilding
+    // Returns true if the buffers were rebuilt this call
+    bool update(const RadialParams& params, FrameArena& arena);
+
+    // Force the next update() to rebuild
+    void invalidate() { valid = false; }
+
+    GLuint bresenhamBuffer() const { return bresenhamVbo; }
+    GLuint wuBuffer() const { return wuVbo; }
+
+    // Vertex counts of the cached scene (Wu in the format of params.packed)
+    GLsizei bresenhamCount() const { return bresenhamVertices; }
+    GLsizei wuCount() const { return wuVertices; }
+
+private:
+    GLuint bresenhamVbo = 0;
+    GLuint wuVbo = 0;
+    GLsizei bresenhamVertices = 0;
+    GLsizei wuVertices = 0;
+
+    RadialParams cached = {};
+    bool valid = false;
+};
@@ -0,0 +1,135 @@
+#include "GpuLineRasterizer.h"
+
+#include <cmath>
+
+void GpuLineRasterizer::init(GLuint program, GLuint quadProgram, int targetWidth, int targetHeight) {
+    shaderProgram = program;
+    quadShaderProgram = quadProgram;
+
+    cellOffsetLoc = glGetUniformLocation(shaderProgram, "cellOffset");
+    useCellColorLoc = glGetUniformLocation(shaderProgram, "useCellColor");
+    lineModeLoc = glGetUniformLocation(shaderProgram, "lineMode");
+    lineColorLoc = glGetUniformLocation(shaderProgram, "lineColor");
+
+    glUniformBlockBinding(shaderProgram, glGetUniformBlockIndex(shaderProgram, "Cells"), 0);
+
+    quadCellOffsetLoc = glGetUniformLocation(quadShaderProgram, "cellOffset");
+    quadLineColorLoc = glGetUniformLocation(quadShaderProgram, "lineColor");
+    quadCombineLoc = glGetUniformLocation(quadShaderProgram, "combine");
+
+    glUniformBlockBinding(quadShaderProgram, glGetUniformBlockIndex(quadShaderProgram, "Cells"), 0);
+
+    setTargetSize(targetWidth, targetHeight);
+
+    stream.init(sizeof(Line), 1024);
+    glGenVertexArrays(1, &vao);
+    setupAttributes(0);
+}
+
+void GpuLineRasterizer::setTargetSize(int targetWidth, int targetHeight) {
+    glUseProgram(shaderProgram);
+    glUniform2f(glGetUniformLocation(shaderProgram, "targetSize"), float(targetWidth), float(targetHeight));
+    glUseProgram(quadShaderProgram);
+    glUniform2f(glGetUniformLocation(quadShaderProgram, "targetSize"), float(targetWidth), float(targetHeight));
+    glUseProgram(0);
+}
+
+void GpuLineRasterizer::destroy() {
+    glDeleteVertexArrays(1, &vao);
+    stream.destroy();
+    vao = 0;
+}
+
+void GpuLineRasterizer::upload(std::span<const Line> lines) {
+    if (!beginUpload(static_cast<GLsizei>(lines.size())))
+        return;
+    for (const Line& line : lines)
+        add(line);
+    endUpload();
+}
+
+bool GpuLineRasterizer::beginUpload(GLsizei count) {
+    lineCount = 0;
+    maxBresenhamVertices = 0;
+    maxWuVertices = 0;
+    if (count <= 0)
+        return false;
+
+    // Growing recreates the storage with an empty segment, so it is safe mid-frame;
+    // the attribute pointer is set again in endUpload() anyway
+    stream.reserve(count);
+    slice = static_cast<Line*>(stream.map(count, sliceFirst));
+    next = slice;
+    return slice != nullptr;
+}
+
+void GpuLineRasterizer::add(const Line& line) {
+    // Every instance of a draw gets the same vertex count, enough for the longest line
+    int bresenham = bresenhamLineCount(
+        static_cast<int>(std::round(line.x0)), static_cast<int>(std::round(line.y0)),
+        static_cast<int>(std::round(line.x1)), static_cast<int>(std::round(line.y1)));
+    int wu = xiaolinWuLineCount(line.x0, line.y0, line.x1, line.y1);
+    if (bresenham > maxBresenhamVertices) maxBresenhamVertices = bresenham;
+    if (wu > maxWuVertices) maxWuVertices = wu;
+    *next++ = line;
+}
+
+void GpuLineRasterizer::endUpload() {
+    lineCount = static_cast<GLsizei>(next - slice);
+    stream.unmap();
+    slice = next = nullptr;
+
+    // Instanced attributes ignore the draw's first vertex, so point the
+    // attribute at this frame's slice instead
+    setupAttributes(sliceFirst);
+}
+
+void GpuLineRasterizer::drawBresenham(int cellOffset) {
+    glUseProgram(shaderProgram);
+    glUniform1i(useCellColorLoc, GL_TRUE);
+    draw(0, cellOffset, maxBresenhamVertices);
+}
+
+void GpuLineRasterizer::drawWu(int cellOffset, float r, float g, float b) {
+    glUseProgram(shaderProgram);
+    glUniform1i(useCellColorLoc, GL_FALSE);
+    glUniform3f(lineColorLoc, r, g, b);
+    draw(1, cellOffset, maxWuVertices);
+}
+
+void GpuLineRasterizer::drawWuQuads(int cellOffset, float r, float g, float b, int combine) {
+    if (lineCount == 0)
+        return;
+
+    glUseProgram(quadShaderProgram);
+    glUniform1i(quadCellOffsetLoc, cellOffset);
+    glUniform3f(quadLineColorLoc, r, g, b);
+    glUniform1i(quadCombineLoc, combine);
+
+    // Same VAO, the line attribute is at location 0 in both programs
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, 2 * lineCount);
+}
+
+void GpuLineRasterizer::setupAttributes(GLint first) {
+    glBindVertexArray(vao);
+    glBindBuffer(GL_ARRAY_BUFFER, stream.buffer());
+
+    // One Line per instance pair (both cells of an algorithm)
+    glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(Line), (void*)(static_cast<size_t>(first) * sizeof(Line)));
+    glVertexAttribDivisor(0, 2);
+    glEnableVertexAttribArray(0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
+
+void GpuLineRasterizer::draw(int mode, int cellOffset, GLsizei verticesPerLine) {
+    if (lineCount == 0 || verticesPerLine == 0)
+        return;
+
+    glUniform1i(lineModeLoc, mode);
+    glUniform1i(cellOffsetLoc, cellOffset);
+    glBindVertexArray(vao);
+    glDrawArraysInstanced(GL_POINTS, 0, verticesPerLine, 2 * lineCount);
+}
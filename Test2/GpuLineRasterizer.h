@@ -0,0 +1,81 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <span>
+
+#include "Rasterizer.h"
+#include "StreamBuffer.h"
+
+// GPU line backend
+// Uploads only the Line endpoints (16 bytes per line) and rasterizes them in
+// gpu_line_vertex_shader.glsl: each draw is instanced per line and per cell,
+// and every vertex of an instance computes one pixel from gl_VertexID.
+// CPU cost scales with the number of lines instead of the number of pixels.
+//
+// Wu lines can also be drawn as one quad per line (4 vertices instead of two
+// per pixel column) with the coverage computed in the fragment shader, see
+// gpu_line_quad_vertex_shader.glsl. Both use the same uploaded lines.
+// Every quad is a line on its own, so a polyline drawn this way would blend
+// its joints twice: polylines go through rasterizePolyline instead.
+class GpuLineRasterizer {
+public:
+    // program: linked gpu_line_vertex_shader.glsl + fragment_shader.glsl
+    // quadProgram: linked gpu_line_quad_vertex_shader.glsl + gpu_line_quad_fragment_shader.glsl
+    void init(GLuint program, GLuint quadProgram, int targetWidth, int targetHeight);
+    void destroy();
+
+    // Pixel size the line endpoints are relative to
+    void setTargetSize(int targetWidth, int targetHeight);
+
+    // Stream this frame's lines, call once per frame after beginFrame()
+    void upload(std::span<const Line> lines);
+
+    // Or write them straight into this frame's slice of the stream instead of
+    // copying them: beginUpload(count), add() each line, endUpload(). The slice
+    // is write only, so the longest line is tracked as the lines go in.
+    // Returns false (and nothing is drawn) if there is no room.
+    bool beginUpload(GLsizei count);
+    void add(const Line& line);
+    void endUpload();
+
+    // Draw the uploaded lines into the two cells starting at cellOffset
+    // Bresenham takes its color from the cell table, Wu uses (r, g, b)
+    void drawBresenham(int cellOffset);
+    void drawWu(int cellOffset, float r, float g, float b);
+
+    // Wu as quads. combine is how the target pixels under one fragment add up:
+    // 0 = alpha blended like separate points, 1 = max, 2 = sum (for the coverage buffer modes)
+    void drawWuQuads(int cellOffset, float r, float g, float b, int combine = 0);
+
+    void beginFrame() { stream.beginFrame(); }
+    void endFrame() { stream.endFrame(); }
+
+    GLuint program() const { return shaderProgram; }
+
+private:
+    void setupAttributes(GLint first);
+    void draw(int mode, int cellOffset, GLsizei verticesPerLine);
+
+    GLuint shaderProgram = 0;
+    GLuint vao = 0;
+    StreamBuffer stream;
+
+    Line* next = nullptr;   // write position between beginUpload() and endUpload()
+    Line* slice = nullptr;
+    GLint sliceFirst = 0;
+
+    GLsizei lineCount = 0;
+    GLsizei maxBresenhamVertices = 0; // longest line, in vertices
+    GLsizei maxWuVertices = 0;
+
+    GLint cellOffsetLoc = -1;
+    GLint useCellColorLoc = -1;
+    GLint lineModeLoc = -1;
+    GLint lineColorLoc = -1;
+
+    GLuint quadShaderProgram = 0;
+    GLint quadCellOffsetLoc = -1;
+    GLint quadLineColorLoc = -1;
+    GLint quadCombineLoc = -1;
+};
@@ -0,0 +1,95 @@
+#include "GpuSineRasterizer.h"
+
+#include <vector>
+
+void GpuSineRasterizer::init(GLuint program, int targetWidth, int targetHeight) {
+    shaderProgram = program;
+
+    cellOffsetLoc = glGetUniformLocation(shaderProgram, "cellOffset");
+    useCellColorLoc = glGetUniformLocation(shaderProgram, "useCellColor");
+    lineModeLoc = glGetUniformLocation(shaderProgram, "lineMode");
+    lineColorLoc = glGetUniformLocation(shaderProgram, "lineColor");
+    amplitudeLoc = glGetUniformLocation(shaderProgram, "amplitude");
+    frequencyLoc = glGetUniformLocation(shaderProgram, "frequency");
+    timeLoc = glGetUniformLocation(shaderProgram, "time");
+
+    glUniformBlockBinding(shaderProgram, glGetUniformBlockIndex(shaderProgram, "Cells"), 0);
+    setTargetSize(targetWidth, targetHeight);
+
+    glGenBuffers(1, &vbo);
+    glGenVertexArrays(1, &vaoBresenham);
+    glGenVertexArrays(1, &vaoWu);
+
+    // Same buffer, Bresenham skips every second copy with a doubled stride
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBindVertexArray(vaoBresenham);
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(vaoWu);
+    glVertexAttribPointer(0, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)0);
+    glEnableVertexAttribArray(0);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuSineRasterizer::setTargetSize(int targetWidth, int targetHeight) {
+    glUseProgram(shaderProgram);
+    glUniform2f(glGetUniformLocation(shaderProgram, "targetSize"), float(targetWidth), float(targetHeight));
+    glUseProgram(0);
+}
+
+void GpuSineRasterizer::destroy() {
+    glDeleteVertexArrays(1, &vaoBresenham);
+    glDeleteVertexArrays(1, &vaoWu);
+    glDeleteBuffers(1, &vbo);
+    vaoBresenham = vaoWu = vbo = 0;
+    columnCount = 0;
+}
+
+void GpuSineRasterizer::setWave(const SineWave& wave) {
+    glUseProgram(shaderProgram);
+    glUniform1f(amplitudeLoc, wave.amplitude);
+    glUniform1f(frequencyLoc, wave.frequency);
+    glUniform1f(timeLoc, wave.phase);
+    glUseProgram(0);
+
+    if (wave.xStart == xStart && wave.xEnd == xEnd)
+        return;
+    xStart = wave.xStart;
+    xEnd = wave.xEnd;
+
+    // Every column twice: the Wu floor and upper pixel
+    columnCount = static_cast<GLsizei>(sineWaveCount(wave));
+    std::vector<float> columns(2 * static_cast<size_t>(columnCount));
+    for (GLsizei i = 0; i < columnCount; ++i) {
+        columns[2 * i] = float(xStart + i);
+        columns[2 * i + 1] = float(xStart + i);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glBufferData(GL_ARRAY_BUFFER, columns.size() * sizeof(float), columns.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void GpuSineRasterizer::drawBresenham(int cellOffset) {
+    if (columnCount == 0)
+        return;
+    glUseProgram(shaderProgram);
+    glUniform1i(useCellColorLoc, GL_TRUE);
+    glUniform1i(lineModeLoc, 0);
+    glUniform1i(cellOffsetLoc, cellOffset);
+    glBindVertexArray(vaoBresenham);
+    glDrawArraysInstanced(GL_POINTS, 0, columnCount, 2);
+}
+
+void GpuSineRasterizer::drawWu(int cellOffset, float r, float g, float b) {
+    if (columnCount == 0)
+        return;
+    glUseProgram(shaderProgram);
+    glUniform1i(useCellColorLoc, GL_FALSE);
+    glUniform1i(lineModeLoc, 1);
+    glUniform1i(cellOffsetLoc, cellOffset);
+    glUniform3f(lineColorLoc, r, g, b);
+    glBindVertexArray(vaoWu);
+    glDrawArraysInstanced(GL_POINTS, 0, 2 * columnCount, 2);
+}
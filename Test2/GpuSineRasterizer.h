@@ -0,0 +1,47 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include "Rasterizer.h"
+
+// GPU sine backend
+// The pixel columns of the wave are uploaded once into a static buffer and
+// sine_vertex_shader.glsl evaluates y and the Wu floor/fract split from the
+// time uniform. While only the phase changes, a frame does no CPU work for
+// the curve and uploads nothing.
+class GpuSineRasterizer {
+public:
+    // program: linked sine_vertex_shader.glsl + fragment_shader.glsl
+    void init(GLuint program, int targetWidth, int targetHeight);
+    void destroy();
+
+    // Pixel size of the target the wave is drawn in (its center line is targetHeight / 2)
+    void setTargetSize(int targetWidth, int targetHeight);
+
+    // Set the wave, phase included (the shader's time uniform)
+    // The columns are only uploaded again when xStart/xEnd change.
+    void setWave(const SineWave& wave);
+
+    // Draw into the two cells starting at cellOffset
+    // Bresenham takes its color from the cell table, Wu uses (r, g, b)
+    void drawBresenham(int cellOffset);
+    void drawWu(int cellOffset, float r, float g, float b);
+
+    GLuint program() const { return shaderProgram; }
+
+private:
+    GLuint shaderProgram = 0;
+    GLuint vbo = 0;
+    GLuint vaoBresenham = 0; // every second column copy
+    GLuint vaoWu = 0;        // both copies
+    GLsizei columnCount = 0;
+    int xStart = 0, xEnd = -1;
+
+    GLint cellOffsetLoc = -1;
+    GLint useCellColorLoc = -1;
+    GLint lineModeLoc = -1;
+    GLint lineColorLoc = -1;
+    GLint amplitudeLoc = -1;
+    GLint frequencyLoc = -1;
+    GLint timeLoc = -1;
+};
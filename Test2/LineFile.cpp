@@ -0,0 +1,323 @@
+#include "LineFile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ---------- MappedFile ----------
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE handle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) {
+        std::cerr << "ERROR: Could not open " << path << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(handle, &length) || length.QuadPart == 0) {
+        std::cerr << "ERROR: " << path << " is empty" << std::endl;
+        CloseHandle(handle);
+        return false;
+    }
+
+    // Takes no address space, only the views of it do
+    HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        std::cerr << "ERROR: Could not map " << path << std::endl;
+        CloseHandle(handle);
+        return false;
+    }
+
+    fileHandle = handle;
+    mappingHandle = mapping;
+    fileSize = static_cast<uint64_t>(length.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    unmap();
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+    fileSize = 0;
+}
+
+uint64_t MappedFile::granularity() {
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwAllocationGranularity;
+}
+
+// FILE_FLAG_SEQUENTIAL_SCAN already asks for read-ahead
+const unsigned char* MappedFile::mapRange(uint64_t start, size_t length) {
+    void* mapped = MapViewOfFile(mappingHandle, FILE_MAP_READ, DWORD(start >> 32), DWORD(start & 0xFFFFFFFFu), length);
+    return static_cast<const unsigned char*>(mapped);
+}
+
+void MappedFile::unmap() {
+    if (view) UnmapViewOfFile(view);
+    view = nullptr;
+    viewOffset = 0;
+    viewLength = 0;
+}
+
+#else
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    int handle = ::open(path.c_str(), O_RDONLY);
+    if (handle < 0) {
+        std::cerr << "ERROR: Could not open " << path << std::endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(handle, &info) != 0 || info.st_size == 0) {
+        std::cerr << "ERROR: " << path << " is empty" << std::endl;
+        ::close(handle);
+        return false;
+    }
+
+    fd = handle;
+    fileSize = static_cast<uint64_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    unmap();
+    if (fd >= 0) ::close(fd);
+    fd = -1;
+    fileSize = 0;
+}
+
+uint64_t MappedFile::granularity() {
+    return static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+const unsigned char* MappedFile::mapRange(uint64_t start, size_t length) {
+    if (start > static_cast<uint64_t>(std::numeric_limits<off_t>::max()))
+        return nullptr; // 32-bit off_t, needs _FILE_OFFSET_BITS=64
+    void* mapped = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(start));
+    if (mapped == MAP_FAILED)
+        return nullptr;
+    madvise(mapped, length, MADV_SEQUENTIAL); // windows are read front to back
+    return static_cast<const unsigned char*>(mapped);
+}
+
+void MappedFile::unmap() {
+    if (view) munmap(const_cast<unsigned char*>(view), viewLength);
+    view = nullptr;
+    viewOffset = 0;
+    viewLength = 0;
+}
+
+#endif
+
+const unsigned char* MappedFile::map(uint64_t offset, size_t length) {
+    if (offset > fileSize || length > fileSize - offset) {
+        std::cerr << "ERROR: Bytes " << offset << " to " << offset + length
+            << " are outside the mapped file (" << fileSize << " bytes)" << std::endl;
+        return nullptr;
+    }
+    if (view && offset >= viewOffset && offset + length <= viewOffset + viewLength)
+        return view + (offset - viewOffset);
+
+    // A view starts on the granularity: 64 KB on Windows, a page elsewhere
+    unmap();
+    static const uint64_t align = granularity();
+    uint64_t start = offset / align * align;
+    uint64_t mapLength = offset - start + length;
+    const unsigned char* mapped = mapLength <= SIZE_MAX ? mapRange(start, static_cast<size_t>(mapLength)) : nullptr;
+    if (!mapped) {
+        std::cerr << "ERROR: Could not map bytes " << offset << " to " << offset + length << std::endl;
+        return nullptr;
+    }
+
+    view = mapped;
+    viewOffset = start;
+    viewLength = static_cast<size_t>(mapLength);
+    return view + (offset - start);
+}
+
+// ---------- LineFile ----------
+
+bool LineFile::open(const std::string& path) {
+    close();
+    if (!file.open(path))
+        return false;
+
+    auto fail = [&](const char* reason) {
+        std::cerr << "ERROR: " << path << " is not a valid line file (" << reason << ")" << std::endl;
+        close();
+        return false;
+    };
+
+    if (file.size() < sizeof(LineFileHeader))
+        return fail("too small");
+
+    LineFileHeader header;
+    const unsigned char* headerBytes = file.map(0, sizeof(header));
+    if (!headerBytes)
+        return fail("header can't be mapped");
+    std::memcpy(&header, headerBytes, sizeof(header));
+    if (std::memcmp(header.magic, "WULN", 4) != 0)
+        return fail("bad magic");
+    if (header.version != LINE_FILE_VERSION)
+        return fail("unsupported version");
+    if (header.kind != LineFileKind::Lines && header.kind != LineFileKind::Points)
+        return fail("unknown kind");
+    fileKind = header.kind;
+
+    uint64_t indexBytes = uint64_t(header.chunkCount) * sizeof(LineFileChunk);
+    if (header.indexOffset > file.size() || indexBytes > file.size() - header.indexOffset)
+        return fail("chunk index out of range");
+
+    // The index is copied, the records are only mapped window by window
+    chunks.resize(header.chunkCount);
+    if (header.chunkCount) {
+        const unsigned char* index = indexBytes <= SIZE_MAX ? file.map(header.indexOffset, static_cast<size_t>(indexBytes)) : nullptr;
+        if (!index)
+            return fail("chunk index can't be mapped");
+        std::memcpy(chunks.data(), index, static_cast<size_t>(indexBytes));
+    }
+    file.unmap();
+
+    uint64_t records = 0;
+    for (const LineFileChunk& c : chunks) {
+        if (c.offset % 4 != 0 || c.offset > file.size() || uint64_t(c.count) * recordSize() > file.size() - c.offset)
+            return fail("chunk out of range");
+        records += c.count;
+    }
+    if (records != header.recordCount)
+        return fail("record count mismatch");
+    return true;
+}
+
+void LineFile::close() {
+    file.close();
+    chunks.clear();
+}
+
+size_t LineFile::segmentCount(size_t chunk) const {
+    size_t count = chunks[chunk].count;
+    if (fileKind == LineFileKind::Lines)
+        return count;
+    return count > 1 ? count - 1 : 0;
+}
+
+std::span<const Line> LineFile::segments(size_t chunk, size_t first, size_t count, FrameArena& arena) {
+    // count segments of points need count + 1 points
+    size_t records = fileKind == LineFileKind::Lines ? count : count + 1;
+    const unsigned char* bytes = file.map(chunks[chunk].offset + uint64_t(first) * recordSize(), records * recordSize());
+    if (!bytes)
+        return {};
+    if (fileKind == LineFileKind::Lines)
+        return { reinterpret_cast<const Line*>(bytes), count };
+
+    // Segment i joins points i and i + 1
+    const Point* points = reinterpret_cast<const Point*>(bytes);
+    std::span<Line> lines = arena.allocate<Line>(count);
+    for (size_t i = 0; i < count; ++i)
+        lines[i] = { points[i].x, points[i].y, points[i + 1].x, points[i + 1].y };
+    return lines;
+}
+
+void LineFile::release() {
+    file.unmap();
+}
+
+// ---------- Writers ----------
+
+template <typename Record, typename Bounds>
+static bool writeRecords(const std::string& path, LineFileKind kind, std::span<const Record> records,
+    uint32_t chunkRecords, uint32_t overlap, Bounds bounds) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out.is_open()) {
+        std::cerr << "ERROR: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    // Chunk i starts at record i * step and repeats the last overlap records of chunk i - 1
+    chunkRecords = std::max(chunkRecords, overlap + 1);
+    size_t step = chunkRecords - overlap;
+
+    std::vector<LineFileChunk> chunks;
+    uint64_t offset = sizeof(LineFileHeader);
+    uint64_t recordCount = 0;
+    for (size_t first = 0; first < records.size(); first += step) {
+        size_t count = std::min<size_t>(chunkRecords, records.size() - first);
+        if (first > 0 && count <= overlap)
+            break; // everything left is already in the previous chunk
+
+        LineFileChunk c = {};
+        c.offset = offset;
+        c.count = static_cast<uint32_t>(count);
+        c.bounds[0] = c.bounds[1] = INFINITY;
+        c.bounds[2] = c.bounds[3] = -INFINITY;
+        for (size_t i = first; i < first + count; ++i)
+            bounds(records[i], c.bounds);
+        chunks.push_back(c);
+
+        offset += count * sizeof(Record);
+        recordCount += count;
+    }
+
+    LineFileHeader header = {};
+    std::memcpy(header.magic, "WULN", 4);
+    header.version = LINE_FILE_VERSION;
+    header.kind = kind;
+    header.chunkCount = static_cast<uint32_t>(chunks.size());
+    header.recordCount = recordCount;
+    header.indexOffset = offset;
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (size_t i = 0; i < chunks.size(); ++i)
+        out.write(reinterpret_cast<const char*>(records.data() + i * step), chunks[i].count * sizeof(Record));
+    out.write(reinterpret_cast<const char*>(chunks.data()), chunks.size() * sizeof(LineFileChunk));
+
+    if (!out) {
+        std::cerr << "ERROR: Could not write " << path << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static void growBounds(float x, float y, float* b) {
+    b[0] = std::min(b[0], x);
+    b[1] = std::min(b[1], y);
+    b[2] = std::max(b[2], x);
+    b[3] = std::max(b[3], y);
+}
+
+bool writeLineFile(const std::string& path, std::span<const Line> lines, uint32_t chunkRecords) {
+    return writeRecords(path, LineFileKind::Lines, lines, chunkRecords, 0, [](const Line& l, float* b) {
+        growBounds(l.x0, l.y0, b);
+        growBounds(l.x1, l.y1, b);
+    });
+}
+
+bool writePointFile(const std::string& path, std::span<const Point> points, uint32_t chunkRecords) {
+    return writeRecords(path, LineFileKind::Points, points, chunkRecords, 1, [](const Point& p, float* b) {
+        growBounds(p.x, p.y, b);
+    });
+}
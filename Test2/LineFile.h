@@ -0,0 +1,165 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BatchRasterizer.h"
+#include "FrameArena.h"
+#include "Polyline.h"
+#include "Rasterizer.h"
+
+// ---------- Binary line files ----------
+// Large segment and point dumps are memory mapped instead of read through a
+// stream, and consumed in fixed-size windows straight from the mapping, so
+// memory stays bounded by the window and drawing starts on the first window.
+// Only the window being read is mapped, never the whole file, so a 32-bit
+// build handles multi-gigabyte dumps as well, its address space only has to
+// hold one window.
+//
+// Layout (little endian):
+//   LineFileHeader
+//   records, chunk after chunk: Line (16 bytes) or Point (8 bytes)
+//   LineFileChunk[chunkCount] at indexOffset
+// A points file is a set of polylines, one per chunk.
+
+enum class LineFileKind : uint32_t {
+    Lines = 0,  // independent segments
+    Points = 1, // every chunk is one polyline
+};
+
+struct LineFileHeader {
+    char magic[4];        // "WULN"
+    uint32_t version;     // LINE_FILE_VERSION
+    LineFileKind kind;
+    uint32_t chunkCount;
+    uint64_t recordCount; // lines or points in all chunks
+    uint64_t indexOffset; // byte offset of the chunk index
+};
+static_assert(sizeof(LineFileHeader) == 32, "LineFileHeader is part of the file format");
+
+struct LineFileChunk {
+    uint64_t offset;  // byte offset of the first record, 4-byte aligned
+    uint32_t count;   // records
+    uint32_t reserved;
+    float bounds[4];  // minX, minY, maxX, maxY of the records, to skip chunks off screen
+};
+static_assert(sizeof(LineFileChunk) == 32, "LineFileChunk is part of the file format");
+
+const uint32_t LINE_FILE_VERSION = 1;
+const uint32_t LINE_FILE_CHUNK = 64 * 1024; // records per chunk the writers emit
+const size_t LINE_FILE_WINDOW = 16 * 1024;  // segments per window when streaming
+
+// Read-only file mapped one view at a time
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    uint64_t size() const { return fileSize; }
+
+    // Bytes [offset, offset + length) of the file, valid until the next map(),
+    // unmap() or close(). Replaces the current view unless that already holds
+    // the range. Prints an ERROR and returns nullptr if the range is outside
+    // the file or can't be mapped.
+    const unsigned char* map(uint64_t offset, size_t length);
+
+    // Drop the current view, its pages can go
+    void unmap();
+
+private:
+    // Platform part of map(), start is a multiple of the granularity
+    static uint64_t granularity();
+    const unsigned char* mapRange(uint64_t start, size_t length);
+
+    uint64_t fileSize = 0;
+    const unsigned char* view = nullptr; // starts at viewOffset, a multiple of the mapping granularity
+    uint64_t viewOffset = 0;
+    size_t viewLength = 0;
+#ifdef _WIN32
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#else
+    int fd = -1;
+#endif
+};
+
+class LineFile {
+public:
+    // Maps the file and validates the header and chunk index
+    // Prints an ERROR and returns false if it isn't a valid line file
+    bool open(const std::string& path);
+    void close();
+
+    LineFileKind kind() const { return fileKind; }
+    size_t chunkCount() const { return chunks.size(); }
+    const LineFileChunk& chunk(size_t i) const { return chunks[i]; }
+
+    // Segments of a chunk: its lines, or one less than its points
+    size_t segmentCount(size_t chunk) const;
+
+    // Segments [first, first + count) of a chunk, mapped for this call
+    // Lines are a view of the mapping (valid until the next segments() or
+    // release()), points are joined into lines in the arena. Empty if the
+    // window can't be mapped.
+    std::span<const Line> segments(size_t chunk, size_t first, size_t count, FrameArena& arena);
+
+    // Done with the last segments, their window is unmapped
+    void release();
+
+private:
+    size_t recordSize() const { return fileKind == LineFileKind::Lines ? sizeof(Line) : sizeof(Point); }
+
+    MappedFile file;
+    LineFileKind fileKind = LineFileKind::Lines;
+    std::vector<LineFileChunk> chunks;
+};
+
+// Write lines / one polyline to a line file, chunkRecords records per chunk
+// (consecutive point chunks repeat the shared point). Returns false on I/O errors.
+bool writeLineFile(const std::string& path, std::span<const Line> lines, uint32_t chunkRecords = LINE_FILE_CHUNK);
+bool writePointFile(const std::string& path, std::span<const Point> points, uint32_t chunkRecords = LINE_FILE_CHUNK);
+
+// Visit the file's segments in windows of at most windowSize, in file order.
+// The arena is reset before every window, so only one window is alive at a
+// time. Chunks whose bounds miss skip (inclusive, pixels) are never touched.
+template <typename Visit>
+void streamLineFile(LineFile& file, FrameArena& arena, Visit&& visit,
+    size_t windowSize = LINE_FILE_WINDOW, const ClipRect* skip = nullptr) {
+    for (size_t c = 0; c < file.chunkCount(); ++c) {
+        if (skip) {
+            const float* b = file.chunk(c).bounds;
+            if (b[2] < float(skip->x0) || b[0] > float(skip->x1) || b[3] < float(skip->y0) || b[1] > float(skip->y1))
+                continue;
+        }
+
+        size_t count = file.segmentCount(c);
+        for (size_t first = 0; first < count; first += windowSize) {
+            size_t n = count - first < windowSize ? count - first : windowSize;
+            arena.reset();
+            visit(file.segments(c, first, n, arena));
+            file.release();
+        }
+    }
+}
+
+// streamLineFile through rasterizeLines: visit gets each window's RasterOutput
+// (valid until it returns), chunks outside the target are skipped
+template <typename Visit>
+void rasterizeLineFile(LineFile& file, RasterMode mode, int width, int height, FrameArena& arena, Visit&& visit,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f, uint8_t colorIndex = 0,
+    size_t windowSize = LINE_FILE_WINDOW) {
+    // Wu reaches 2 pixels past the line (see clipWuLine)
+    ClipRect target = { -2, -2, width + 1, height + 1 };
+    streamLineFile(file, arena, [&](std::span<const Line> lines) {
+        visit(rasterizeLines(lines, mode, width, height, arena, r, g, b, colorIndex));
+    }, windowSize, &target);
+}
@@ -0,0 +1,196 @@
+#include "LineScene.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// Two triangles per cell, two cells per line (see scene_vertex_shader.glsl)
+static const GLsizei VERTICES_PER_LINE = 12;
+
+static uint8_t toUnorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+void LineScene::init(GLuint program, int targetWidth, int targetHeight) {
+    shaderProgram = program;
+
+    cellOffsetLoc = glGetUniformLocation(shaderProgram, "cellOffset");
+    combineLoc = glGetUniformLocation(shaderProgram, "combine");
+
+    setTargetSize(targetWidth, targetHeight);
+
+    glUseProgram(shaderProgram);
+    glUniform1i(glGetUniformLocation(shaderProgram, "lineEndpoints"), 0);
+    glUniform1i(glGetUniformLocation(shaderProgram, "lineColors"), 1);
+    glUniform1i(glGetUniformLocation(shaderProgram, "lineWidths"), 2);
+    glUseProgram(0);
+
+    glUniformBlockBinding(shaderProgram, glGetUniformBlockIndex(shaderProgram, "Cells"), 0);
+
+    // At least 65536 texels on GL 3.3, usually far more
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+
+    GLuint* objects[3] = { lineBuffer, colorBuffer, widthBuffer };
+    for (GLuint* object : objects) {
+        glGenBuffers(1, &object[0]);
+        glGenTextures(1, &object[1]);
+    }
+    glGenVertexArrays(1, &vao);
+}
+
+void LineScene::setTargetSize(int targetWidth, int targetHeight) {
+    glUseProgram(shaderProgram);
+    glUniform2f(glGetUniformLocation(shaderProgram, "targetSize"), float(targetWidth), float(targetHeight));
+    glUseProgram(0);
+}
+
+void LineScene::destroy() {
+    GLuint* objects[3] = { lineBuffer, colorBuffer, widthBuffer };
+    for (GLuint* object : objects) {
+        glDeleteTextures(1, &object[1]);
+        glDeleteBuffers(1, &object[0]);
+        object[0] = object[1] = 0;
+    }
+    glDeleteVertexArrays(1, &vao);
+    vao = 0;
+    gpuCapacity = 0;
+}
+
+uint32_t LineScene::add(const Line& line, const LineStyle& style) {
+    if (lines.size() >= static_cast<size_t>(maxTexels)) {
+        std::cerr << "ERROR: LineScene is full (" << maxTexels << " lines, GL_MAX_TEXTURE_BUFFER_SIZE)" << std::endl;
+        return INVALID_ID;
+    }
+
+    uint32_t id = static_cast<uint32_t>(lines.size());
+    lines.push_back(line);
+    colors.push_back({});
+    widths.push_back(0.0f);
+    visible.push_back(1);
+    setStyle(id, style);
+    runsDirty = true;
+    return id;
+}
+
+void LineScene::setLine(uint32_t id, const Line& line) {
+    lines[id] = line;
+    markDirty(id);
+}
+
+void LineScene::setStyle(uint32_t id, const LineStyle& style) {
+    colors[id] = { toUnorm8(style.r), toUnorm8(style.g), toUnorm8(style.b), toUnorm8(style.opacity) };
+    widths[id] = style.width;
+    markDirty(id);
+}
+
+void LineScene::setVisible(uint32_t id, bool show) {
+    uint8_t value = show ? 1 : 0;
+    if (visible[id] == value)
+        return;
+    visible[id] = value;
+    runsDirty = true;
+}
+
+void LineScene::clear() {
+    lines.clear();
+    colors.clear();
+    widths.clear();
+    visible.clear();
+    dirtyBegin = dirtyEnd = 0;
+    runsDirty = true;
+}
+
+void LineScene::markDirty(uint32_t id) {
+    if (dirtyBegin == dirtyEnd) {
+        dirtyBegin = id;
+        dirtyEnd = id + 1;
+        return;
+    }
+    dirtyBegin = std::min<size_t>(dirtyBegin, id);
+    dirtyEnd = std::max<size_t>(dirtyEnd, id + 1);
+}
+
+void LineScene::upload() {
+    struct Property {
+        GLuint* objects;
+        const void* data;
+        size_t texelSize;
+        GLenum format;
+    };
+    Property properties[3] = {
+        { lineBuffer, lines.data(), sizeof(Line), GL_RGBA32F },
+        { colorBuffer, colors.data(), sizeof(Color), GL_RGBA8 },
+        { widthBuffer, widths.data(), sizeof(float), GL_R32F },
+    };
+
+    if (lines.size() > gpuCapacity) {
+        // Grow by doubling so adding lines one at a time stays cheap, the
+        // whole scene goes up once with the new storage
+        gpuCapacity = std::max(lines.size(), 2 * gpuCapacity);
+        for (const Property& p : properties) {
+            glBindBuffer(GL_TEXTURE_BUFFER, p.objects[0]);
+            glBufferData(GL_TEXTURE_BUFFER, gpuCapacity * p.texelSize, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_TEXTURE_BUFFER, 0, lines.size() * p.texelSize, p.data);
+
+            // The texture keeps pointing at the old storage until attached again
+            glBindTexture(GL_TEXTURE_BUFFER, p.objects[1]);
+            glTexBuffer(GL_TEXTURE_BUFFER, p.format, p.objects[0]);
+        }
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+    else if (dirtyBegin < dirtyEnd) {
+        for (const Property& p : properties) {
+            glBindBuffer(GL_TEXTURE_BUFFER, p.objects[0]);
+            glBufferSubData(GL_TEXTURE_BUFFER, dirtyBegin * p.texelSize, (dirtyEnd - dirtyBegin) * p.texelSize,
+                static_cast<const char*>(p.data) + dirtyBegin * p.texelSize);
+        }
+        glBindBuffer(GL_TEXTURE_BUFFER, 0);
+    }
+    dirtyBegin = dirtyEnd = 0;
+}
+
+void LineScene::buildRuns() {
+    runFirst.clear();
+    runCount.clear();
+    size_t i = 0;
+    while (i < visible.size()) {
+        if (!visible[i]) {
+            ++i;
+            continue;
+        }
+        size_t start = i;
+        while (i < visible.size() && visible[i])
+            ++i;
+        runFirst.push_back(static_cast<GLint>(start * VERTICES_PER_LINE));
+        runCount.push_back(static_cast<GLsizei>((i - start) * VERTICES_PER_LINE));
+    }
+    runsDirty = false;
+}
+
+void LineScene::draw(int cellOffset, int combine) {
+    upload();
+    if (runsDirty)
+        buildRuns();
+    if (runFirst.empty())
+        return;
+
+    glUseProgram(shaderProgram);
+    glUniform1i(cellOffsetLoc, cellOffset);
+    glUniform1i(combineLoc, combine);
+
+    GLuint textures[3] = { lineBuffer[1], colorBuffer[1], widthBuffer[1] };
+    for (int i = 0; i < 3; ++i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_BUFFER, textures[i]);
+    }
+
+    glBindVertexArray(vao);
+    glMultiDrawArrays(GL_TRIANGLES, runFirst.data(), runCount.data(), static_cast<GLsizei>(runFirst.size()));
+    glBindVertexArray(0);
+
+    for (int i = 2; i >= 0; --i) {
+        glActiveTexture(GL_TEXTURE0 + i);
+        glBindTexture(GL_TEXTURE_BUFFER, 0);
+    }
+}
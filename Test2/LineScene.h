@@ -0,0 +1,88 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "Rasterizer.h"
+
+// Per-line properties of a LineScene
+struct LineStyle {
+    float r, g, b;
+    float opacity; // multiplies the Wu coverage
+    float width;   // minor-axis thickness in pixels, 1 = Wu's line
+};
+
+// Batched Wu line scene
+// Every line gets an ID, its endpoints and style live in buffer textures
+// indexed by that ID (GL 3.3 has no SSBOs), so lines of any color, width and
+// opacity share one program and one vertex-less draw. The scene is drawn as
+// Wu quads (gpu_line_quad_fragment_shader.glsl) with a single
+// glMultiDrawArrays: one entry per run of visible lines, so hiding lines
+// costs entries, not draw calls.
+//
+// Only lines changed since the last draw are uploaded again.
+class LineScene {
+public:
+    static const uint32_t INVALID_ID = UINT32_MAX;
+
+    // program: linked scene_vertex_shader.glsl + gpu_line_quad_fragment_shader.glsl
+    void init(GLuint program, int targetWidth, int targetHeight);
+    void destroy();
+
+    // Pixel size the line endpoints are relative to
+    void setTargetSize(int targetWidth, int targetHeight);
+
+    // Returns the new line's ID (IDs are dense, in insertion order),
+    // INVALID_ID if the buffer textures can't hold another line
+    uint32_t add(const Line& line, const LineStyle& style);
+
+    void setLine(uint32_t id, const Line& line);
+    void setStyle(uint32_t id, const LineStyle& style);
+    void setVisible(uint32_t id, bool visible);
+
+    // Remove every line, IDs start again at 0
+    void clear();
+
+    size_t size() const { return lines.size(); }
+
+    // Upload what changed and draw both cells starting at cellOffset in one call
+    // combine: as in GpuLineRasterizer::drawWuQuads
+    void draw(int cellOffset, int combine = 0);
+
+private:
+    // Texels of the buffer textures, one per line each
+    struct Color {
+        uint8_t r, g, b, a; // GL_RGBA8, normalized on fetch
+    };
+
+    void markDirty(uint32_t id);
+    void upload();
+    void buildRuns();
+
+    GLuint shaderProgram = 0;
+    GLuint vao = 0; // empty, the vertex shader fetches everything by ID
+    GLint cellOffsetLoc = -1;
+    GLint combineLoc = -1;
+    GLint maxTexels = 0;
+
+    // Buffer (0) and texture (1) of each property
+    GLuint lineBuffer[2] = {};
+    GLuint colorBuffer[2] = {};
+    GLuint widthBuffer[2] = {};
+    size_t gpuCapacity = 0; // lines the buffers were allocated for
+
+    std::vector<Line> lines;
+    std::vector<Color> colors;
+    std::vector<float> widths;
+    std::vector<uint8_t> visible;
+
+    // Lines changed since the last upload, [dirtyBegin, dirtyEnd)
+    size_t dirtyBegin = 0, dirtyEnd = 0;
+
+    // glMultiDrawArrays ranges, rebuilt when visibility changes
+    std::vector<GLint> runFirst;
+    std::vector<GLsizei> runCount;
+    bool runsDirty = false;
+};
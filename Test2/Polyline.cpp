@@ -0,0 +1,191 @@
+#include "Polyline.h"
+#include "WuKernels.h"
+
+#include <algorithm>
+
+// One covered pixel of a polyline before it is converted to an output format
+struct PixelSample {
+    float px, py, alpha;
+};
+
+struct PixelSampleSink {
+    PixelSample* out;
+
+    void plot(float px, float py, float alpha) {
+        *out++ = { px, py, alpha };
+    }
+};
+
+// Pixels of a segment that are close enough to the shared endpoint to overlap
+// the previous segments (the endpoint column and the main-loop column next to it)
+static const float JOINT_REACH = 3.0f;
+static const int MAX_JOINT_PIXELS = 64;
+
+// Merge the new segment [start, end) into the earlier ones [scanFrom, start)
+// around the joint p: a pixel both cover keeps the higher coverage and is only
+// emitted once. Returns the new end of the samples.
+// Segments drawn with wuSegmentDispatch only overlap where the major axis or
+// the direction changes at the joint, and then both samples are main-loop
+// coverage, so the higher one is the right one.
+static size_t mergeJoint(std::span<PixelSample> samples, size_t scanFrom, size_t start, size_t end, Point p) {
+    auto nearJoint = [&](const PixelSample& s) {
+        return std::abs(s.px - p.x) <= JOINT_REACH && std::abs(s.py - p.y) <= JOINT_REACH;
+    };
+
+    size_t earlier[MAX_JOINT_PIXELS];
+    int earlierCount = 0;
+    for (size_t j = scanFrom; j < start && earlierCount < MAX_JOINT_PIXELS; ++j) {
+        if (nearJoint(samples[j]))
+            earlier[earlierCount++] = j;
+    }
+
+    size_t write = start;
+    for (size_t k = start; k < end; ++k) {
+        PixelSample s = samples[k];
+        bool merged = false;
+        if (nearJoint(s)) {
+            for (int e = 0; e < earlierCount; ++e) {
+                PixelSample& other = samples[earlier[e]];
+                if (other.px == s.px && other.py == s.py) {
+                    other.alpha = std::max(other.alpha, s.alpha);
+                    merged = true;
+                    break;
+                }
+            }
+        }
+        if (!merged)
+            samples[write++] = s;
+    }
+    return write;
+}
+
+// Wu pixels of the whole polyline, joints merged
+static std::span<PixelSample> polylineSamples(std::span<const Point> points, FrameArena& arena) {
+    if (points.size() < 2)
+        return {};
+
+    std::span<PixelSample> samples = arena.allocate<PixelSample>(polylineWuBound(points));
+
+    // Index of the last point that starts a segment, its end is no joint
+    size_t last = 0;
+    for (size_t i = 1; i < points.size(); ++i)
+        if (points[i - 1].x != points[i].x || points[i - 1].y != points[i].y)
+            last = i;
+
+    size_t count = 0;
+    size_t lastStart = 0, previousStart = 0; // the two segments before this one
+    bool first = true;
+    for (size_t i = 1; i < points.size(); ++i) {
+        Point a = points[i - 1], b = points[i];
+        if (a.x == b.x && a.y == b.y)
+            continue; // repeated point, nothing to draw
+
+        size_t start = count;
+        PixelSampleSink sink{ samples.data() + start };
+        wuSegmentDispatch(a.x, a.y, b.x, b.y, !first, i < last, sink);
+        size_t end = static_cast<size_t>(sink.out - samples.data());
+
+        // Short segments can leave the joint within reach of the one before too
+        if (!first)
+            end = mergeJoint(samples, previousStart, start, end, a);
+
+        previousStart = first ? start : lastStart;
+        lastStart = start;
+        first = false;
+        count = end;
+    }
+    return samples.first(count);
+}
+
+size_t polylineWuBound(std::span<const Point> points) {
+    // Every segment on its own, merging and joints only remove pixels
+    size_t bound = 0;
+    for (size_t i = 1; i < points.size(); ++i)
+        bound += xiaolinWuLineCount(points[i - 1].x, points[i - 1].y, points[i].x, points[i].y);
+    return bound;
+}
+
+Vertex* rasterizePolyline(std::span<const Point> points,
+    int width, int height, FrameArena& arena, Vertex* out,
+    float r, float g, float b) {
+    OutputMapping map = outputMapping(width, height);
+    for (const PixelSample& s : polylineSamples(points, arena))
+        *out++ = { map.x(s.px), map.y(s.py), r, g, b, s.alpha };
+    return out;
+}
+
+PackedVertex* rasterizePolylinePacked(std::span<const Point> points,
+    FrameArena& arena, PackedVertex* out, uint8_t colorIndex) {
+    for (const PixelSample& s : polylineSamples(points, arena))
+        *out++ = packVertex(s.px, s.py, s.alpha, colorIndex);
+    return out;
+}
+
+std::span<Vertex> rasterizePolyline(std::span<const Point> points,
+    int width, int height, FrameArena& arena,
+    float r, float g, float b) {
+    std::span<PixelSample> samples = polylineSamples(points, arena);
+    std::span<Vertex> vertices = arena.allocate<Vertex>(samples.size());
+    OutputMapping map = outputMapping(width, height);
+    for (size_t i = 0; i < samples.size(); ++i) {
+        const PixelSample& s = samples[i];
+        vertices[i] = { map.x(s.px), map.y(s.py), r, g, b, s.alpha };
+    }
+    return vertices;
+}
+
+std::span<PackedVertex> rasterizePolylinePacked(std::span<const Point> points,
+    FrameArena& arena, uint8_t colorIndex) {
+    std::span<PixelSample> samples = polylineSamples(points, arena);
+    std::span<PackedVertex> vertices = arena.allocate<PackedVertex>(samples.size());
+    for (size_t i = 0; i < samples.size(); ++i)
+        vertices[i] = packVertex(samples[i].px, samples[i].py, samples[i].alpha, colorIndex);
+    return vertices;
+}
+
+void rasterizePolyline(std::span<const Point> points, Framebuffer& target, FrameArena& arena,
+    float r, float g, float b) {
+    for (const PixelSample& s : polylineSamples(points, arena))
+        target.blend(static_cast<int>(s.px), static_cast<int>(s.py), r, g, b, s.alpha);
+}
+
+static int pixel(float v) { return static_cast<int>(std::round(v)); }
+
+size_t polylineBresenhamCount(std::span<const Point> points) {
+    if (points.empty())
+        return 0;
+
+    // A single point is one pixel, otherwise every segment after the first drops its first pixel
+    size_t count = 1;
+    for (size_t i = 1; i < points.size(); ++i)
+        count += bresenhamLineCount(pixel(points[i - 1].x), pixel(points[i - 1].y), pixel(points[i].x), pixel(points[i].y)) - 1;
+    return count;
+}
+
+float* rasterizePolylineBresenham(std::span<const Point> points,
+    int width, int height, float* out) {
+    if (points.empty())
+        return out;
+    if (points.size() == 1)
+        return bresenhamLine(pixel(points[0].x), pixel(points[0].y), pixel(points[0].x), pixel(points[0].y), width, height, out);
+
+    for (size_t i = 1; i < points.size(); ++i) {
+        int x0 = pixel(points[i - 1].x), y0 = pixel(points[i - 1].y);
+        int x1 = pixel(points[i].x), y1 = pixel(points[i].y);
+        if (i > 1) {
+            if (x0 == x1 && y0 == y1)
+                continue; // the pixel is already there
+            // Write over the previous segment's last pixel, it is this one's first
+            out -= 2;
+        }
+        out = bresenhamLine(x0, y0, x1, y1, width, height, out);
+    }
+    return out;
+}
+
+std::span<float> rasterizePolylineBresenham(std::span<const Point> points,
+    int width, int height, FrameArena& arena) {
+    std::span<float> vertices = arena.allocate<float>(2 * polylineBresenhamCount(points));
+    float* end = rasterizePolylineBresenham(points, width, height, vertices.data());
+    return vertices.first(static_cast<size_t>(end - vertices.data()));
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "FrameArena.h"
+#include "Rasterizer.h"
+
+class Framebuffer;
+
+// Point of a polyline or curve (pixels)
+struct Point {
+    float x, y;
+};
+
+// ---------- Polylines ----------
+// Consecutive segments share their endpoint. At a joint neither segment
+// draws Wu's endpoint column, each covers its side of it with main-loop
+// coverage (see wuSegmentDispatch), so a straight polyline gives the same
+// pixels as one line. Pixels both segments cover where the polyline turns
+// are merged (highest coverage wins) instead of being blended twice.
+
+// Wu polyline as Vertex, allocated from the frame arena
+std::span<Vertex> rasterizePolyline(std::span<const Point> points,
+    int width, int height, FrameArena& arena,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+// Wu polyline as PackedVertex
+std::span<PackedVertex> rasterizePolylinePacked(std::span<const Point> points,
+    FrameArena& arena, uint8_t colorIndex = 0);
+
+// Wu polyline blended into a framebuffer (arena is scratch only)
+void rasterizePolyline(std::span<const Point> points, Framebuffer& target, FrameArena& arena,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+// Bresenham polyline as (x, y) pairs, points rounded to pixels
+// Every segment after the first skips its first pixel, the end of the previous one
+std::span<float> rasterizePolylineBresenham(std::span<const Point> points,
+    int width, int height, FrameArena& arena);
+
+// ---------- Output-buffer overloads ----------
+// Write into out and return the end of the written range, so the vertices
+// can go straight into a mapped buffer. out is only written, never read.
+
+// Upper bound of the Wu vertices of a polyline (merged joints make it less)
+size_t polylineWuBound(std::span<const Point> points);
+
+// Exact number of (x, y) pairs of the Bresenham polyline
+size_t polylineBresenhamCount(std::span<const Point> points);
+
+// Write at most polylineWuBound() vertices, arena is scratch for the joint merge
+Vertex* rasterizePolyline(std::span<const Point> points,
+    int width, int height, FrameArena& arena, Vertex* out,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+PackedVertex* rasterizePolylinePacked(std::span<const Point> points,
+    FrameArena& arena, PackedVertex* out, uint8_t colorIndex = 0);
+
+// Writes polylineBresenhamCount() pairs
+float* rasterizePolylineBresenham(std::span<const Point> points,
+    int width, int height, float* out);
+
+// ---------- Adaptive tessellation ----------
+
+// Distance from p to the segment (a, b)
+inline float distanceToSegment(Point p, Point a, Point b) {
+    float dx = b.x - a.x, dy = b.y - a.y;
+    float lengthSq = dx * dx + dy * dy;
+    float t = lengthSq > 0.0f ? ((p.x - a.x) * dx + (p.y - a.y) * dy) / lengthSq : 0.0f;
+    if (t < 0.0f) t = 0.0f;
+    if (t > 1.0f) t = 1.0f;
+    float ex = a.x + t * dx - p.x, ey = a.y + t * dy - p.y;
+    return std::sqrt(ex * ex + ey * ey);
+}
+
+// Appends points of curve(t) for t in [t0, t1] to out, both ends included
+// An interval is split until the curve at its 1/4, 1/2 and 3/4 points is within
+// tolerance pixels of the chord, so flat parts get long segments and only
+// curved parts get short ones. minSegments uniform intervals come first so a
+// feature smaller than the whole range can't hide between two samples, and
+// maxDepth bounds the subdivision of each of them.
+template <typename Curve>
+void tessellateCurve(Curve&& curve, float t0, float t1, float tolerance, std::vector<Point>& out,
+    int minSegments = 8, int maxDepth = 12) {
+    struct Interval {
+        float ta, tb;
+        Point a, b;
+        int depth;
+    };
+
+    if (minSegments < 1) minSegments = 1;
+    out.push_back(curve(t0));
+
+    // Explicit stack, the right half is pushed first so points come out in order
+    std::vector<Interval> stack;
+    for (int i = minSegments - 1; i >= 0; --i) {
+        float ta = t0 + (t1 - t0) * i / minSegments;
+        float tb = (i + 1 == minSegments) ? t1 : t0 + (t1 - t0) * (i + 1) / minSegments;
+        stack.push_back({ ta, tb, curve(ta), curve(tb), 0 });
+    }
+
+    while (!stack.empty()) {
+        Interval iv = stack.back();
+        stack.pop_back();
+
+        float tm = 0.5f * (iv.ta + iv.tb);
+        Point m = curve(tm);
+        bool flat = iv.depth >= maxDepth ||
+            (distanceToSegment(m, iv.a, iv.b) <= tolerance &&
+             distanceToSegment(curve(0.5f * (iv.ta + tm)), iv.a, iv.b) <= tolerance &&
+             distanceToSegment(curve(0.5f * (tm + iv.tb)), iv.a, iv.b) <= tolerance);
+
+        if (flat) {
+            out.push_back(iv.b);
+            continue;
+        }
+        stack.push_back({ tm, iv.tb, m, iv.b, iv.depth + 1 });
+        stack.push_back({ iv.ta, tm, iv.a, m, iv.depth + 1 });
+    }
+}
@@ -0,0 +1,579 @@
+#include "Rasterizer.h"
+#include "WuKernels.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <utility>
+
+// Read by worker threads (batch rasterizer, frame pipeline) while the render
+// loop sets it every frame
+static std::atomic<OutputSpace> activeSpace{ OutputSpace::Ndc };
+
+OutputSpace getOutputSpace() {
+    return activeSpace.load(std::memory_order_relaxed);
+}
+
+void setOutputSpace(OutputSpace space) {
+    activeSpace.store(space, std::memory_order_relaxed);
+}
+
+// Generate radial lines from center (x0, y0) with given radius and angle step
+int generateLinesCount(int angleStep) {
+    return angleStep > 0 ? (359 / angleStep) + 1 : 0;
+}
+
+Line radialLine(int x0, int y0, int radius, int angleStep, int i) {
+    double rad = (i * angleStep) * (3.14159) / 180.0;
+    float x1 = x0 + static_cast<float>(radius * cos(rad));
+    float y1 = y0 + static_cast<float>(radius * sin(rad));
+    return { static_cast<float>(x0), static_cast<float>(y0), x1, y1 };
+}
+
+std::vector<Line> generateLines(int x0, int y0, int radius, int angleStep) {
+    std::vector<Line> lines(generateLinesCount(angleStep));
+    for (int i = 0; i < int(lines.size()); ++i)
+        lines[i] = radialLine(x0, y0, radius, angleStep, i);
+    return lines;
+}
+
+std::span<Line> generateLines(int x0, int y0, int radius, int angleStep, FrameArena& arena) {
+    std::span<Line> lines = arena.allocate<Line>(generateLinesCount(angleStep));
+    for (int i = 0; i < int(lines.size()); ++i)
+        lines[i] = radialLine(x0, y0, radius, angleStep, i);
+    return lines;
+}
+
+// Sine wave
+// Note that we sample at every pixel column so Wu can blend adjacent pixels
+int sineWaveCount(const SineWave& wave) {
+    int count = wave.xEnd - wave.xStart + 1;
+    return count > 0 ? count : 0;
+}
+
+float* sineWaveBresenham(const SineWave& wave, int width, int height, float* out) {
+    OutputMapping map = outputMapping(width, height);
+    for (int x = wave.xStart; x <= wave.xEnd; ++x) {
+        float y = height / 2 + wave.amplitude * sin(wave.frequency * x + wave.phase);
+
+        // Bresenham: just pixel centers (one vertex per column)
+        // In pixel space y is rounded to its pixel, NDC keeps the exact curve
+        *out++ = map.x(float(x));
+        *out++ = map.pixels ? std::floor(y + 0.5f) : map.y(y);
+    }
+    return out;
+}
+
+Vertex* sineWaveWu(const SineWave& wave, int width, int height, Vertex* out, float r, float g, float b) {
+    OutputMapping map = outputMapping(width, height);
+    for (int x = wave.xStart; x <= wave.xEnd; ++x) {
+        float y = height / 2 + wave.amplitude * sin(wave.frequency * x + wave.phase);
+
+        // Wu: use floor + fractional part (dont round)
+        float y_floor = std::floor(y);
+        float frac = y - y_floor; // 0..1
+
+        float ndcX = map.x(float(x));
+        float ndcY1 = map.y(y_floor);        // lower (floor) pixel
+        float ndcY2 = map.y(y_floor + 1);    // upper (ceil) pixel
+        *out++ = { ndcX, ndcY1, r, g, b, 1.0f - frac };
+        *out++ = { ndcX, ndcY2, r, g, b, frac };
+    }
+    return out;
+}
+
+PackedVertex* sineWaveWuPacked(const SineWave& wave, int height, PackedVertex* out, uint8_t colorIndex) {
+    for (int x = wave.xStart; x <= wave.xEnd; ++x) {
+        float y = height / 2 + wave.amplitude * sin(wave.frequency * x + wave.phase);
+        float y_floor = std::floor(y);
+        float frac = y - y_floor;
+        *out++ = packVertex(float(x), y_floor, 1.0f - frac, colorIndex);
+        *out++ = packVertex(float(x), y_floor + 1, frac, colorIndex);
+    }
+    return out;
+}
+
+int bresenhamLineCount(int x0, int y0, int x1, int y1) {
+    int dx = std::abs(x1 - x0);
+    int dy = std::abs(y1 - y0);
+    return (dx > dy ? dx : dy) + 1;
+}
+
+int xiaolinWuLineCount(float x0, float y0, float x1, float y1) {
+    // Same steep/swap logic as xiaolinWuLine, only the major axis matters
+    bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
+    float X0 = steep ? y0 : x0;
+    float X1 = steep ? y1 : x1;
+    if (X0 > X1) std::swap(X0, X1);
+
+    // Two endpoint columns plus the main loop from floor(X0) + 1 to ceil(X1) - 1
+    int inner = int(std::ceil(X1)) - int(std::floor(X0)) - 1;
+    return 4 + 2 * (inner > 0 ? inner : 0);
+}
+
+// Bresenham lines
+// Only uses integer arithmetic (other than NDC conversion)
+// plot(x, y) receives every pixel from (x0, y0) to (x1, y1)
+template <typename Plot>
+static void bresenhamSteps(int x0, int y0, int x1, int y1, Plot&& plot) {
+    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy, e2;
+
+    while (true) {
+        plot(x0, y0);
+
+        if (x0 == x1 && y0 == y1) break;
+        e2 = 2 * err;
+        if (e2 >= dy) { err += dy; x0 += sx; }
+        if (e2 <= dx) { err += dx; y0 += sy; }
+    }
+}
+
+// Bresenham in closed form: with the major axis stepped once per pixel, the
+// loop above puts pixel i at minor offset (2 * i * minor + major) / (2 * major).
+// That lets a clipped line start at any step with the exact error term.
+struct BresenhamClip {
+    int first, last;       // step range inside the rectangle
+    int x0, y0, sx, sy;
+    int major, minor;
+    bool xMajor;
+};
+
+// Smallest step whose minor offset is >= k
+static long long bresenhamFirstStep(long long k, long long major, long long minor) {
+    if (k <= 0) return 0;
+    if (minor == 0) return major + 1; // never
+    long long num = major * (2 * k - 1), den = 2 * minor;
+    return (num + den - 1) / den;
+}
+
+// Largest step whose minor offset is <= k
+static long long bresenhamLastStep(long long k, long long major, long long minor) {
+    if (k < 0) return -1;
+    if (minor == 0) return major;
+    long long num = major * (2 * k + 1), den = 2 * minor;
+    return (num + den - 1) / den - 1;
+}
+
+// Direction and axes of a line, all steps 0..major in range
+static void bresenhamSetup(int x0, int y0, int x1, int y1, BresenhamClip& clip) {
+    int adx = std::abs(x1 - x0), ady = std::abs(y1 - y0);
+    clip.x0 = x0; clip.y0 = y0;
+    clip.sx = x0 < x1 ? 1 : -1;
+    clip.sy = y0 < y1 ? 1 : -1;
+    clip.xMajor = adx >= ady;
+    clip.major = clip.xMajor ? adx : ady;
+    clip.minor = clip.xMajor ? ady : adx;
+    clip.first = 0;
+    clip.last = clip.major;
+}
+
+static bool bresenhamClipRange(int x0, int y0, int x1, int y1, const ClipRect& rect, BresenhamClip& clip) {
+    bresenhamSetup(x0, y0, x1, y1, clip);
+
+    // Steps along the major axis that stay inside
+    int p = clip.xMajor ? x0 : y0, s = clip.xMajor ? clip.sx : clip.sy;
+    int lo = clip.xMajor ? rect.x0 : rect.y0, hi = (clip.xMajor ? rect.x1 : rect.y1) - 1;
+    long long first = 0, last = clip.major;
+    if (s > 0) { first = std::max<long long>(first, lo - p); last = std::min<long long>(last, hi - p); }
+    else { first = std::max<long long>(first, p - hi); last = std::min<long long>(last, p - lo); }
+
+    // Minor offsets that stay inside, turned into steps
+    p = clip.xMajor ? y0 : x0; s = clip.xMajor ? clip.sy : clip.sx;
+    lo = clip.xMajor ? rect.y0 : rect.x0; hi = (clip.xMajor ? rect.y1 : rect.x1) - 1;
+    long long fa = s > 0 ? lo - p : p - hi;
+    long long fb = s > 0 ? hi - p : p - lo;
+    if (clip.major > 0) {
+        first = std::max(first, bresenhamFirstStep(fa, clip.major, clip.minor));
+        last = std::min(last, bresenhamLastStep(fb, clip.major, clip.minor));
+    }
+    else if (fa > 0 || fb < 0) {
+        return false; // single pixel outside
+    }
+
+    if (first > last)
+        return false;
+    clip.first = static_cast<int>(first);
+    clip.last = static_cast<int>(last);
+    return true;
+}
+
+// plot(x, y) receives the pixels of the clipped range, in order
+template <typename Plot>
+static void bresenhamClippedSteps(const BresenhamClip& clip, Plot&& plot) {
+    // Integer error term of the closed form: minor offset f is n / (2 * major)
+    long long twoMajor = 2LL * clip.major;
+    long long n = 2LL * clip.first * clip.minor + clip.major;
+    long long f = clip.major > 0 ? n / twoMajor : 0;
+    long long next = twoMajor * (f + 1);
+
+    for (int i = clip.first; i <= clip.last; ++i) {
+        if (clip.xMajor) plot(clip.x0 + clip.sx * i, clip.y0 + clip.sy * static_cast<int>(f));
+        else plot(clip.x0 + clip.sx * static_cast<int>(f), clip.y0 + clip.sy * i);
+
+        n += 2LL * clip.minor;
+        if (n >= next) { ++f; next += twoMajor; }
+    }
+}
+
+// Run slicing: run(i0, i1, f) receives the steps i0..i1 that share the minor
+// offset f, in order. A run ends at the last step of its offset,
+// ceil(major * (2f + 1) / (2 * minor)) - 1; the numerator grows by 2 * major
+// per run, so the quotient is carried forward instead of divided again.
+template <typename Run>
+static void bresenhamClippedRuns(const BresenhamClip& clip, Run&& run) {
+    if (clip.minor == 0) {
+        run(clip.first, clip.last, 0LL);
+        return;
+    }
+
+    long long major = clip.major, den = 2LL * clip.minor;
+    long long f = (2LL * clip.first * clip.minor + major) / (2 * major);
+    long long num = major * (2 * f + 1);
+    long long end = (num + den - 1) / den; // first step past the run
+    long long rem = end * den - num;       // 0 <= rem < den
+    long long stepEnd = (2 * major) / den, stepRem = (2 * major) % den;
+
+    long long i = clip.first;
+    while (i <= clip.last) {
+        long long last = std::min<long long>(end - 1, clip.last);
+        run(i, last, f);
+        i = last + 1;
+        ++f;
+        end += stepEnd;
+        rem -= stepRem;
+        if (rem < 0) { ++end; rem += den; }
+    }
+}
+
+// Steps i0..i1 at minor offset f as a run from its lowest pixel
+static PixelSpan bresenhamSpan(const BresenhamClip& clip, long long i0, long long i1, long long f) {
+    int length = static_cast<int>(i1 - i0 + 1);
+    int s = clip.xMajor ? clip.sx : clip.sy;
+    int start = static_cast<int>((clip.xMajor ? clip.x0 : clip.y0) + s * (s > 0 ? i0 : i1));
+    int minor = static_cast<int>((clip.xMajor ? clip.y0 : clip.x0) + (clip.xMajor ? clip.sy : clip.sx) * f);
+    if (clip.xMajor) return { start, minor, length, 0 };
+    return { minor, start, length, 1 };
+}
+
+int bresenhamSpanCount(int x0, int y0, int x1, int y1) {
+    return std::min(std::abs(x1 - x0), std::abs(y1 - y0)) + 1;
+}
+
+PixelSpan* bresenhamSpans(int x0, int y0, int x1, int y1, PixelSpan* out) {
+    BresenhamClip clip;
+    bresenhamSetup(x0, y0, x1, y1, clip);
+    bresenhamClippedRuns(clip, [&](long long i0, long long i1, long long f) {
+        *out++ = bresenhamSpan(clip, i0, i1, f);
+    });
+    return out;
+}
+
+std::span<PixelSpan> bresenhamSpans(int x0, int y0, int x1, int y1, FrameArena& arena) {
+    std::span<PixelSpan> spans = arena.allocate<PixelSpan>(bresenhamSpanCount(x0, y0, x1, y1));
+    bresenhamSpans(x0, y0, x1, y1, spans.data());
+    return spans;
+}
+
+PixelSpan* bresenhamSpansClipped(int x0, int y0, int x1, int y1, const ClipRect& rect, PixelSpan* out) {
+    BresenhamClip clip;
+    if (!bresenhamClipRange(x0, y0, x1, y1, rect, clip))
+        return out;
+    bresenhamClippedRuns(clip, [&](long long i0, long long i1, long long f) {
+        *out++ = bresenhamSpan(clip, i0, i1, f);
+    });
+    return out;
+}
+
+int bresenhamLineCountClipped(int x0, int y0, int x1, int y1, const ClipRect& rect) {
+    BresenhamClip clip;
+    return bresenhamClipRange(x0, y0, x1, y1, rect, clip) ? clip.last - clip.first + 1 : 0;
+}
+
+float* bresenhamLineClipped(int x0, int y0, int x1, int y1, int width, int height, const ClipRect& rect, float* out) {
+    BresenhamClip clip;
+    if (!bresenhamClipRange(x0, y0, x1, y1, rect, clip))
+        return out;
+    OutputMapping map = outputMapping(width, height);
+    bresenhamClippedSteps(clip, [&](int x, int y) {
+        *out++ = map.x(float(x));
+        *out++ = map.y(float(y));
+    });
+    return out;
+}
+
+// Liang-Barsky: every edge is a constraint p * t <= q on the line parameter
+bool clipLine(float& x0, float& y0, float& x1, float& y1, float xmin, float ymin, float xmax, float ymax) {
+    float dx = x1 - x0, dy = y1 - y0;
+    float t0 = 0.0f, t1 = 1.0f;
+
+    auto edge = [&](float p, float q) {
+        if (p == 0.0f)
+            return q >= 0.0f; // parallel to this edge, inside or not at all
+        float t = q / p;
+        if (p < 0.0f) {
+            if (t > t1) return false;
+            if (t > t0) t0 = t;
+        }
+        else {
+            if (t < t0) return false;
+            if (t < t1) t1 = t;
+        }
+        return true;
+    };
+
+    if (!edge(-dx, x0 - xmin) || !edge(dx, xmax - x0) ||
+        !edge(-dy, y0 - ymin) || !edge(dy, ymax - y0))
+        return false;
+
+    // Endpoints inside keep their exact value
+    float ox = x0, oy = y0;
+    if (t0 > 0.0f) { x0 = ox + t0 * dx; y0 = oy + t0 * dy; }
+    if (t1 < 1.0f) { x1 = ox + t1 * dx; y1 = oy + t1 * dy; }
+    return true;
+}
+
+bool clipWuLine(float& x0, float& y0, float& x1, float& y1, const ClipRect& rect) {
+    // Two pixels of margin: a clipped endpoint's own column and the main-loop
+    // column next to it land outside, as does the pixel above the line
+    const float margin = 2.0f;
+    return clipLine(x0, y0, x1, y1,
+        rect.x0 - margin, rect.y0 - margin, rect.x1 - 1 + margin, rect.y1 - 1 + margin);
+}
+
+ClipRect bresenhamLineBounds(int x0, int y0, int x1, int y1) {
+    return { std::min(x0, x1), std::min(y0, y1), std::max(x0, x1) + 1, std::max(y0, y1) + 1 };
+}
+
+ClipRect xiaolinWuLineBounds(float x0, float y0, float x1, float y1) {
+    // Wu reaches a column past the endpoints and the pixel above the line,
+    // which can start a pixel below the endpoint rows
+    const int margin = 2;
+    return {
+        static_cast<int>(std::floor(std::min(x0, x1))) - margin,
+        static_cast<int>(std::floor(std::min(y0, y1))) - margin,
+        static_cast<int>(std::floor(std::max(x0, x1))) + margin + 1,
+        static_cast<int>(std::floor(std::max(y0, y1))) + margin + 1,
+    };
+}
+
+float* bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, float* out) {
+    OutputMapping map = outputMapping(width, height);
+    bresenhamSteps(x0, y0, x1, y1, [&](int x, int y) {
+        *out++ = map.x(float(x));
+        *out++ = map.y(float(y));
+    });
+    return out;
+}
+
+float* bresenhamLineDoubleStep(int x0, int y0, int x1, int y1, int width, int height, float* out) {
+    OutputMapping map = outputMapping(width, height);
+    BresenhamClip clip;
+    bresenhamSetup(x0, y0, x1, y1, clip);
+
+    // Pixel of step i at minor offset f, without a branch on the major axis
+    int xi = clip.xMajor ? clip.sx : 0, xf = clip.xMajor ? 0 : clip.sx;
+    int yi = clip.xMajor ? 0 : clip.sy, yf = clip.xMajor ? clip.sy : 0;
+    auto plot = [&](int i, int f) {
+        out[2 * i] = map.x(float(clip.x0 + xi * i + xf * f));
+        out[2 * i + 1] = map.y(float(clip.y0 + yi * i + yf * f));
+    };
+
+    // Front end: step i has numerator n = 2 * i * minor + major and the
+    // offset goes up when n reaches the next multiple of 2 * major. Back
+    // end: step major has offset minor, and it goes down when n drops below
+    // the current multiple. A step moves n by 2 * minor <= 2 * major, so
+    // each end changes its offset by at most one per step.
+    long long major = clip.major, minor = clip.minor, twoMajor = 2 * major, step = 2 * minor;
+    long long frontN = major, frontNext = twoMajor;
+    long long backN = twoMajor * minor + major, backFloor = twoMajor * minor;
+    int lo = 0, frontF = 0, hi = clip.major, backF = clip.minor;
+    for (; lo < hi; ++lo, --hi) {
+        plot(lo, frontF);
+        plot(hi, backF);
+        frontN += step;
+        if (frontN >= frontNext) { ++frontF; frontNext += twoMajor; }
+        backN -= step;
+        if (backN < backFloor) { --backF; backFloor -= twoMajor; }
+    }
+    if (lo == hi)
+        plot(lo, frontF);
+    return out + 2 * (clip.major + 1);
+}
+
+void bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, std::vector<float>& out) {
+    size_t start = out.size();
+    out.resize(start + 2 * static_cast<size_t>(bresenhamLineCount(x0, y0, x1, y1)));
+    bresenhamLine(x0, y0, x1, y1, width, height, out.data() + start);
+}
+
+std::span<float> bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, FrameArena& arena) {
+    std::span<float> vertices = arena.allocate<float>(2 * static_cast<size_t>(bresenhamLineCount(x0, y0, x1, y1)));
+    bresenhamLine(x0, y0, x1, y1, width, height, vertices.data());
+    return vertices;
+}
+
+std::vector<float> bresenhamLine(int x0, int y0, int x1, int y1, int width, int height) {
+    std::vector<float> vertices;
+    bresenhamLine(x0, y0, x1, y1, width, height, vertices);
+    return vertices;
+}
+
+// Xiaolin Wu antialiasing
+// The algorithm itself lives in WuKernels.h, specialized at compile time on
+// steep/non-steep, the output sink and the color mode. These are the entry points.
+
+Vertex* xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, Vertex* out,
+    float r, float g, float b) {
+    VertexSink<UniformColor> sink{ out, outputMapping(width, height), { { r, g, b } } };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+    return sink.out;
+}
+
+Vertex* xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, Vertex* out,
+    float r0, float g0, float b0, float r1, float g1, float b1) {
+    VertexSink<GradientColor> sink{ out, outputMapping(width, height),
+        GradientColor(x0, y0, x1, y1, { r0, g0, b0 }, { r1, g1, b1 }) };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+    return sink.out;
+}
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, std::vector<Vertex>& out,
+    float r, float g, float b) {
+    size_t start = out.size();
+    out.resize(start + static_cast<size_t>(xiaolinWuLineCount(x0, y0, x1, y1)));
+    xiaolinWuLine(x0, y0, x1, y1, width, height, out.data() + start, r, g, b);
+}
+
+std::span<Vertex> xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, FrameArena& arena,
+    float r, float g, float b) {
+    std::span<Vertex> vertices = arena.allocate<Vertex>(xiaolinWuLineCount(x0, y0, x1, y1));
+    xiaolinWuLine(x0, y0, x1, y1, width, height, vertices.data(), r, g, b);
+    return vertices;
+}
+
+std::vector<Vertex> xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height,
+    float r, float g, float b) {
+    std::vector<Vertex> vertices;
+    xiaolinWuLine(x0, y0, x1, y1, width, height, vertices, r, g, b);
+    return vertices;
+}
+
+// ---------- Packed Xiaolin Wu ----------
+
+PackedVertex packVertex(float px, float py, float alpha, uint8_t colorIndex) {
+    // Pixel coordinates outside the int16 range are far off-screen, clamp them
+    auto toInt16 = [](float v) {
+        if (v < -32768.0f) v = -32768.0f;
+        if (v > 32767.0f) v = 32767.0f;
+        return static_cast<int16_t>(v);
+    };
+    // The second endpoint's xgap can exceed 1, the framebuffer clamps it the same way
+    if (alpha < 0.0f) alpha = 0.0f;
+    if (alpha > 1.0f) alpha = 1.0f;
+    return { toInt16(px), toInt16(py), static_cast<uint8_t>(alpha * 255.0f + 0.5f), colorIndex };
+}
+
+PackedVertex* xiaolinWuLinePacked(float x0, float y0, float x1, float y1,
+    PackedVertex* out, uint8_t colorIndex) {
+    PackedVertexSink sink{ out, colorIndex };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+    return sink.out;
+}
+
+std::span<PackedVertex> xiaolinWuLinePacked(float x0, float y0, float x1, float y1,
+    FrameArena& arena, uint8_t colorIndex) {
+    std::span<PackedVertex> vertices = arena.allocate<PackedVertex>(xiaolinWuLineCount(x0, y0, x1, y1));
+    xiaolinWuLinePacked(x0, y0, x1, y1, vertices.data(), colorIndex);
+    return vertices;
+}
+
+// ---------- Fixed-point Xiaolin Wu ----------
+
+Fixed toFixed(float v) {
+    return static_cast<Fixed>(std::lround(v * static_cast<float>(FIXED_ONE)));
+}
+
+int xiaolinWuLineFixedCount(Fixed x0, Fixed y0, Fixed x1, Fixed y1) {
+    bool steep = std::abs(static_cast<int64_t>(y1) - y0) > std::abs(static_cast<int64_t>(x1) - x0);
+    Fixed X0 = steep ? y0 : x0;
+    Fixed X1 = steep ? y1 : x1;
+    if (X0 > X1) std::swap(X0, X1);
+
+    // floor(X0) and ceil(X1) in whole pixels, as in the kernel
+    int inner = ((X1 + FIXED_ONE - 1) >> FIXED_SHIFT) - (X0 >> FIXED_SHIFT) - 1;
+    return 4 + 2 * (inner > 0 ? inner : 0);
+}
+
+PackedVertex* xiaolinWuLineFixed(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    PackedVertex* out, uint8_t colorIndex) {
+    FixedPackedSink sink{ out, colorIndex };
+    wuFixedLineDispatch(x0, y0, x1, y1, sink);
+    return sink.out;
+}
+
+std::span<PackedVertex> xiaolinWuLineFixed(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    FrameArena& arena, uint8_t colorIndex) {
+    std::span<PackedVertex> vertices = arena.allocate<PackedVertex>(xiaolinWuLineFixedCount(x0, y0, x1, y1));
+    xiaolinWuLineFixed(x0, y0, x1, y1, vertices.data(), colorIndex);
+    return vertices;
+}
+
+PackedVertex* xiaolinWuLineFixedTwoEnded(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    PackedVertex* out, uint8_t colorIndex) {
+    FixedPackedSink sink{ out, colorIndex };
+    wuFixedLineDispatchTwoEnded(x0, y0, x1, y1, sink);
+    return sink.out;
+}
+
+// ---------- Framebuffer targets ----------
+
+// Both are clipped to the viewport first, only visible pixels are visited
+
+void bresenhamLine(int x0, int y0, int x1, int y1, Framebuffer& target, float r, float g, float b) {
+    bresenhamLine(x0, y0, x1, y1, target, { 0, 0, target.viewportWidth(), target.viewportHeight() }, r, g, b);
+}
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target, float r, float g, float b) {
+    if (!clipWuLine(x0, y0, x1, y1, { 0, 0, target.viewportWidth(), target.viewportHeight() }))
+        return;
+    FramebufferSink<UniformColor> sink{ target, { { r, g, b } } };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+}
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target,
+    float r0, float g0, float b0, float r1, float g1, float b1) {
+    // The gradient stays on the unclipped line
+    GradientColor color(x0, y0, x1, y1, { r0, g0, b0 }, { r1, g1, b1 });
+    if (!clipWuLine(x0, y0, x1, y1, { 0, 0, target.viewportWidth(), target.viewportHeight() }))
+        return;
+    FramebufferSink<GradientColor> sink{ target, color };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+}
+
+void bresenhamLine(int x0, int y0, int x1, int y1, Framebuffer& target, const ClipRect& rect,
+    float r, float g, float b) {
+    BresenhamClip clip;
+    if (!bresenhamClipRange(x0, y0, x1, y1, rect, clip))
+        return;
+    bresenhamClippedRuns(clip, [&](long long i0, long long i1, long long f) {
+        PixelSpan span = bresenhamSpan(clip, i0, i1, f);
+        target.fillSpan(span.x, span.y, span.length, span.vertical != 0, r, g, b);
+    });
+}
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target, const ClipRect& rect,
+    float r, float g, float b) {
+    if (!clipWuLine(x0, y0, x1, y1, rect))
+        return;
+    // The clip margin reaches into the neighbouring rects, drop those pixels
+    FramebufferSink<UniformColor> framebufferSink{ target, { { r, g, b } } };
+    RectSink<FramebufferSink<UniformColor>> sink{ framebufferSink, rect };
+    wuLineDispatch(x0, y0, x1, y1, sink);
+}
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "FrameArena.h"
+
+class Framebuffer;
+
+// Vertex structure for Xiaolin Wu lines
+struct Vertex {
+    float x, y;
+    float r, g, b;
+    float alpha;
+};
+
+// Packed vertex structure for Xiaolin Wu lines (6 bytes instead of 24)
+// Integer pixel coordinates and 8-bit coverage, the NDC transform happens in
+// packed_vertex_shader.glsl and the color comes from a per-draw color table.
+struct PackedVertex {
+    int16_t x, y;
+    uint8_t coverage;   // alpha * 255
+    uint8_t colorIndex; // index into the lineColors uniform
+};
+static_assert(sizeof(PackedVertex) == 6, "PackedVertex must stay tightly packed");
+
+// Line structure for generating radial lines
+struct Line {
+    float x0, y0, x1, y1;
+};
+
+// ---------- Output space ----------
+// Coordinates of the float outputs (Bresenham pairs and Vertex). By default
+// they are NDC of the width x height target passed to each call, which costs
+// a divide per coordinate. In Pixels they are the pixel coordinates, whole
+// numbers, width / height are ignored and the vertex shader maps them to
+// NDC with one matrix (see pixelToNdc in vertex_shader.glsl), so a buffer
+// stays valid when the target is resized. PackedVertex is always pixels.
+
+enum class OutputSpace {
+    Ndc,
+    Pixels,
+};
+
+// Space used by every rasterizer, Ndc by default
+// Set it between frames, not while a batch or a pipelined frame is being
+// generated with it (see FramePipeline::flush)
+OutputSpace getOutputSpace();
+void setOutputSpace(OutputSpace space);
+
+// Pixel -> output coordinate, resolved once per call instead of per pixel
+struct OutputMapping {
+    float width, height;
+    bool pixels;
+
+    float x(float px) const { return pixels ? px : (2.0f * (px + 0.5f)) / width - 1.0f; }
+    float y(float py) const { return pixels ? py : (2.0f * (py + 0.5f)) / height - 1.0f; }
+};
+
+inline OutputMapping outputMapping(int width, int height) {
+    return { float(width), float(height), getOutputSpace() == OutputSpace::Pixels };
+}
+
+// Generate radial lines from center (x0, y0) with given radius and angle step
+std::vector<Line> generateLines(int x0, int y0, int radius, int angleStep);
+std::span<Line> generateLines(int x0, int y0, int radius, int angleStep, FrameArena& arena);
+
+// Number of lines generateLines makes, and line i of them on its own,
+// for callers that write the lines somewhere else one at a time
+int generateLinesCount(int angleStep);
+Line radialLine(int x0, int y0, int radius, int angleStep, int i);
+
+// Sine wave sampled once per pixel column from xStart to xEnd (inclusive)
+// y = height / 2 + amplitude * sin(frequency * x + phase)
+struct SineWave {
+    int xStart, xEnd;
+    float amplitude; // pixels
+    float frequency; // controls wavelength
+    float phase;
+};
+
+// Number of samples (one per column)
+int sineWaveCount(const SineWave& wave);
+
+// Bresenham: one (x, y) pair per sample at the pixel center
+float* sineWaveBresenham(const SineWave& wave, int width, int height, float* out);
+
+// Wu: two vertices per sample, split between the pixel below and above the curve
+Vertex* sineWaveWu(const SineWave& wave, int width, int height, Vertex* out,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+PackedVertex* sineWaveWuPacked(const SineWave& wave, int height, PackedVertex* out, uint8_t colorIndex = 0);
+
+// ---------- Output sizes ----------
+// Exact number of vertices each rasterizer emits for a line,
+// so callers can size their buffers once up front.
+
+// Bresenham: one vertex per pixel along the major axis
+int bresenhamLineCount(int x0, int y0, int x1, int y1);
+
+// Wu: two vertices per major-axis column, including both endpoint columns
+int xiaolinWuLineCount(float x0, float y0, float x1, float y1);
+
+// ---------- Clipping ----------
+// Lines that leave the render target are clipped before the main loops,
+// so nothing outside it is generated, uploaded and then thrown away.
+
+// Pixel rectangle [x0, x1) x [y0, y1), usually the whole render target
+struct ClipRect {
+    int x0, y0, x1, y1;
+};
+
+// Liang-Barsky: clip the segment to [xmin, xmax] x [ymin, ymax]
+// The new endpoints stay subpixel. Returns false if nothing is inside.
+bool clipLine(float& x0, float& y0, float& x1, float& y1, float xmin, float ymin, float xmax, float ymax);
+
+// Clip a Wu line to rect with enough margin that every pixel inside rect is
+// still drawn (the endpoint columns and the pixel above the line fall outside)
+bool clipWuLine(float& x0, float& y0, float& x1, float& y1, const ClipRect& rect);
+
+// Bresenham is clipped in pixel steps instead: the pixels are exactly the
+// ones of the unclipped line that are inside rect, the first step inside
+// starts with the error term the full line would have there.
+int bresenhamLineCountClipped(int x0, int y0, int x1, int y1, const ClipRect& rect);
+float* bresenhamLineClipped(int x0, int y0, int x1, int y1, int width, int height, const ClipRect& rect, float* out);
+
+// ---------- Run-slice Bresenham ----------
+// The same pixels as bresenhamLine, as runs along the major axis: a shallow
+// line is a handful of horizontal runs, a steep one vertical runs, one per
+// minor-axis step. Each run costs one loop iteration (no divide) instead of
+// one per pixel, and fills as a row or column.
+
+struct PixelSpan {
+    int32_t x, y;     // lowest pixel of the run
+    int32_t length;   // pixels
+    int32_t vertical; // 0 = run along x, 1 = along y
+};
+
+// One run per minor-axis step
+int bresenhamSpanCount(int x0, int y0, int x1, int y1);
+
+// Writes bresenhamSpanCount() runs to out and returns the end of the written range
+PixelSpan* bresenhamSpans(int x0, int y0, int x1, int y1, PixelSpan* out);
+
+// Allocates from the frame arena
+std::span<PixelSpan> bresenhamSpans(int x0, int y0, int x1, int y1, FrameArena& arena);
+
+// Runs of the pixels inside rect, at most bresenhamSpanCount()
+PixelSpan* bresenhamSpansClipped(int x0, int y0, int x1, int y1, const ClipRect& rect, PixelSpan* out);
+
+// ---------- Bounds ----------
+// Pixel rectangle holding every pixel a line can touch, from the endpoints
+// alone (for damage tracking, see DamageTracker)
+
+ClipRect bresenhamLineBounds(int x0, int y0, int x1, int y1);
+
+// Same two pixels of margin as clipWuLine
+ClipRect xiaolinWuLineBounds(float x0, float y0, float x1, float y1);
+
+// ---------- Bresenham ----------
+// Writes bresenhamLineCount() (x, y) pairs to out and returns the end of the written range
+float* bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, float* out);
+
+// Appends to a caller-owned buffer (grows it exactly once)
+void bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, std::vector<float>& out);
+
+// Allocates from the frame arena
+std::span<float> bresenhamLine(int x0, int y0, int x1, int y1, int width, int height, FrameArena& arena);
+
+std::vector<float> bresenhamLine(int x0, int y0, int x1, int y1, int width, int height);
+
+// Double-step: the same pixels in the same order, two per iteration, one
+// from each end toward the middle. Each end carries its own error term of
+// the closed form (see bresenhamLineClipped), so the two are independent
+// and the halfway ties round exactly as in bresenhamLine.
+float* bresenhamLineDoubleStep(int x0, int y0, int x1, int y1, int width, int height, float* out);
+
+// ---------- Xiaolin Wu ----------
+// Writes xiaolinWuLineCount() vertices to out and returns the end of the written range
+Vertex* xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, Vertex* out,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+// Same pixels, color interpolated from (r0, g0, b0) at (x0, y0) to (r1, g1, b1) at (x1, y1)
+Vertex* xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, Vertex* out,
+    float r0, float g0, float b0, float r1, float g1, float b1);
+
+// Appends to a caller-owned buffer (grows it exactly once)
+void xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, std::vector<Vertex>& out,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+// Allocates from the frame arena
+std::span<Vertex> xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height, FrameArena& arena,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+std::vector<Vertex> xiaolinWuLine(float x0, float y0, float x1, float y1,
+    int width, int height,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+// ---------- Packed Xiaolin Wu ----------
+// Same pixels and coverage as xiaolinWuLine, quantized to PackedVertex
+
+PackedVertex packVertex(float px, float py, float alpha, uint8_t colorIndex = 0);
+
+// Writes xiaolinWuLineCount() vertices to out and returns the end of the written range
+PackedVertex* xiaolinWuLinePacked(float x0, float y0, float x1, float y1,
+    PackedVertex* out, uint8_t colorIndex = 0);
+
+// Allocates from the frame arena
+std::span<PackedVertex> xiaolinWuLinePacked(float x0, float y0, float x1, float y1,
+    FrameArena& arena, uint8_t colorIndex = 0);
+
+// ---------- Fixed-point Xiaolin Wu ----------
+// Integer-only variant for targets without fast float: endpoints, intery and
+// the gradient are 16.16 fixed point, the main loop has no floor, fpart or
+// divide and the 8-bit coverage comes straight from the fractional bits.
+// Output is PackedVertex, same pixels as xiaolinWuLinePacked except where
+// the line passes within rounding of a pixel boundary.
+
+using Fixed = int32_t;
+const int FIXED_SHIFT = 16;
+const Fixed FIXED_ONE = 1 << FIXED_SHIFT;
+
+// Nearest 16.16 value, pixel coordinates must be within the int16 range
+Fixed toFixed(float v);
+
+int xiaolinWuLineFixedCount(Fixed x0, Fixed y0, Fixed x1, Fixed y1);
+
+// Writes xiaolinWuLineFixedCount() vertices to out and returns the end of the written range
+PackedVertex* xiaolinWuLineFixed(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    PackedVertex* out, uint8_t colorIndex = 0);
+
+// Allocates from the frame arena
+std::span<PackedVertex> xiaolinWuLineFixed(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    FrameArena& arena, uint8_t colorIndex = 0);
+
+// Two-ended: the same vertices as xiaolinWuLineFixed, bit for bit, with the
+// main loop drawing one column from each end per iteration. Only the fixed
+// point kernel has this form, the float intery is accumulated with rounding
+// that can't be reproduced from the far end.
+PackedVertex* xiaolinWuLineFixedTwoEnded(Fixed x0, Fixed y0, Fixed x1, Fixed y1,
+    PackedVertex* out, uint8_t colorIndex = 0);
+
+// ---------- Framebuffer targets ----------
+// Plot straight into a CPU framebuffer (viewport-relative pixel coordinates)
+// instead of emitting vertices. Wu pixels are alpha blended, Bresenham is
+// filled run by run (see bresenhamSpans).
+
+void bresenhamLine(int x0, int y0, int x1, int y1, Framebuffer& target, float r, float g, float b);
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f);
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target,
+    float r0, float g0, float b0, float r1, float g1, float b1);
+
+// Only the pixels inside rect (viewport-relative, inside the viewport) are
+// touched, so lines can be drawn one screen tile at a time
+void bresenhamLine(int x0, int y0, int x1, int y1, Framebuffer& target, const ClipRect& rect,
+    float r, float g, float b);
+
+void xiaolinWuLine(float x0, float y0, float x1, float y1, Framebuffer& target, const ClipRect& rect,
+    float r, float g, float b);
@@ -0,0 +1,66 @@
+#include "RenderTarget.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cstring>
+
+void RenderTarget::init(int framebufferWidth, int framebufferHeight) {
+    glGenBuffers(1, &ubo);
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferData(GL_UNIFORM_BUFFER, 2 * 4 * 4 * sizeof(float), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+    glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubo);
+
+    fbWidth = fbHeight = -1; // the first resize always lays out
+    resize(framebufferWidth, framebufferHeight);
+}
+
+void RenderTarget::destroy() {
+    glDeleteBuffers(1, &ubo);
+    ubo = 0;
+}
+
+bool RenderTarget::resize(int framebufferWidth, int framebufferHeight) {
+    if (framebufferWidth == fbWidth && framebufferHeight == fbHeight)
+        return false;
+    fbWidth = framebufferWidth;
+    fbHeight = framebufferHeight;
+    layout();
+    return true;
+}
+
+glm::mat4 RenderTarget::pixelToNdc() const {
+    // Pixel p covers [p - 0.5, p + 0.5], so this is the same
+    // (2 * (p + 0.5)) / size - 1 the rasterizers compute in NDC mode
+    return glm::ortho(-0.5f, float(width()) - 0.5f, -0.5f, float(height()) - 0.5f);
+}
+
+void RenderTarget::layout() {
+    // An odd framebuffer size leaves the last row or column outside every cell
+    int w = fbWidth / 2;
+    int h = fbHeight / 2;
+    const Cell layout[4] = {
+        { 0, h, w, h, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 1.0f } }, // Bresenham, black on white
+        { 0, 0, w, h, { 0.0f, 0.0f, 0.0f, 1.0f }, { 1.0f, 1.0f, 0.0f, 1.0f } }, // Bresenham, yellow on black
+        { w, h, w, h, { 1.0f, 1.0f, 1.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } }, // Wu, white background
+        { w, 0, w, h, { 0.0f, 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, 0.0f, 0.0f } }, // Wu, black background
+    };
+    std::memcpy(cells, layout, sizeof(cells));
+    if (isEmpty())
+        return;
+
+    // Cell uniform block (std140: vec4 cellRect[4]; vec4 cellColor[4];)
+    float cellBlock[2][4][4];
+    for (int i = 0; i < 4; ++i) {
+        const Cell& cell = cells[i];
+        cellBlock[0][i][0] = (2.0f * cell.x) / fbWidth - 1.0f;
+        cellBlock[0][i][1] = (2.0f * cell.y) / fbHeight - 1.0f;
+        cellBlock[0][i][2] = (2.0f * (cell.x + cell.width)) / fbWidth - 1.0f;
+        cellBlock[0][i][3] = (2.0f * (cell.y + cell.height)) / fbHeight - 1.0f;
+        std::memcpy(cellBlock[1][i], cell.color, sizeof(cell.color));
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(cellBlock), cellBlock);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
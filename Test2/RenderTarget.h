@@ -0,0 +1,56 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+// Viewport cell of the 2x2 comparison layout (framebuffer pixels)
+// color is the constant line color for draws without per-vertex color
+struct Cell {
+    int x, y, width, height;
+    float background[4];
+    float color[4];
+};
+
+// Size-dependent rendering state of the window
+// Tracks the real framebuffer size (in pixels, not screen coordinates, so
+// HiDPI windows get their full resolution) and lays the four cells out in
+// it. Everything is rasterized at the size of one cell, the target, so
+// every rasterized pixel is exactly one framebuffer pixel of its cell.
+//
+// The cell uniform block (binding 0, see vertex_shader.glsl) is owned here
+// and rewritten by resize() only when the size actually changed.
+class RenderTarget {
+public:
+    void init(int framebufferWidth, int framebufferHeight);
+    void destroy();
+
+    // Lay the cells out for a new framebuffer size
+    // Returns true when it changed, everything sized to the target must
+    // then be reallocated or rebuilt once.
+    bool resize(int framebufferWidth, int framebufferHeight);
+
+    int framebufferWidth() const { return fbWidth; }
+    int framebufferHeight() const { return fbHeight; }
+
+    // Pixel size of the target the geometry is rasterized for, one cell
+    int width() const { return cells[0].width; }
+    int height() const { return cells[0].height; }
+
+    // Minimized, nothing to draw into
+    bool isEmpty() const { return width() <= 0 || height() <= 0; }
+
+    // Cell 0: top-left, 1: bottom-left (Bresenham), 2: top-right, 3: bottom-right (Wu)
+    const Cell& cell(int i) const { return cells[i]; }
+
+    // Pixel centers of the target to NDC, see the rasterizers' OutputSpace::Pixels
+    glm::mat4 pixelToNdc() const;
+
+    GLuint cellBuffer() const { return ubo; }
+
+private:
+    void layout();
+
+    Cell cells[4] = {};
+    int fbWidth = 0, fbHeight = 0;
+    GLuint ubo = 0;
+};
@@ -0,0 +1,48 @@
+#include "SceneTarget.h"
+
+#include <iostream>
+
+void SceneTarget::init(int width, int height) {
+    glGenRenderbuffers(1, &color);
+    glGenFramebuffers(1, &fbo);
+    resize(width, height);
+}
+
+void SceneTarget::resize(int width, int height) {
+    if (width == targetWidth && height == targetHeight)
+        return;
+    targetWidth = width;
+    targetHeight = height;
+
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+        std::cerr << "ERROR: scene framebuffer is incomplete" << std::endl;
+
+    // Renderbuffer storage starts undefined, and pixels outside every cell
+    // (the odd row or column of an odd size) are never drawn
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void SceneTarget::destroy() {
+    glDeleteFramebuffers(1, &fbo);
+    glDeleteRenderbuffers(1, &color);
+    fbo = color = 0;
+}
+
+void SceneTarget::bind() {
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+}
+
+void SceneTarget::present() {
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+    glBlitFramebuffer(0, 0, targetWidth, targetHeight, 0, 0, targetWidth, targetHeight, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
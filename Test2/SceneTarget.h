@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Persistent offscreen color target of the four cells
+// The default framebuffer's contents are undefined after a swap, so partial
+// redraws (see DamageTracker) go here and the whole target is blitted to the
+// window every frame. Pixels nobody redraws keep last frame's color.
+class SceneTarget {
+public:
+    void init(int width, int height);
+    void destroy();
+
+    // Reallocate the target for a new framebuffer size
+    // The old contents are gone, the new target starts out black.
+    void resize(int width, int height);
+
+    // Draw into the target
+    void bind();
+
+    // Copy the target to the default framebuffer and bind that again
+    void present();
+
+    int width() const { return targetWidth; }
+    int height() const { return targetHeight; }
+
+private:
+    GLuint fbo = 0;
+    GLuint color = 0; // RGBA8 renderbuffer
+    int targetWidth = 0, targetHeight = 0;
+};
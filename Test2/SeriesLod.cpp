@@ -0,0 +1,115 @@
+#include "SeriesLod.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SeriesPyramid::Extremes::add(const Extremes& e) {
+    // Ties keep the earlier sample, like a linear scan would
+    if (e.min < min || (e.min == min && e.minIndex < minIndex)) { min = e.min; minIndex = e.minIndex; }
+    if (e.max > max || (e.max == max && e.maxIndex < maxIndex)) { max = e.max; maxIndex = e.maxIndex; }
+}
+
+void SeriesPyramid::build(std::span<const float> samples) {
+    values = samples;
+    levels.clear();
+
+    // Finest level straight from the samples, a partial last bucket included
+    std::vector<Extremes> level((samples.size() + SERIES_BUCKET - 1) / SERIES_BUCKET);
+    for (size_t b = 0; b < level.size(); ++b) {
+        size_t first = b * SERIES_BUCKET;
+        size_t last = std::min(first + SERIES_BUCKET, samples.size());
+        Extremes e = { samples[first], samples[first], first, first };
+        for (size_t i = first + 1; i < last; ++i)
+            e.add({ samples[i], samples[i], i, i });
+        level[b] = e;
+    }
+
+    // Every coarser level merges pairs of the one below
+    while (level.size() > 1) {
+        std::vector<Extremes> coarser((level.size() + 1) / 2);
+        for (size_t b = 0; b < coarser.size(); ++b) {
+            coarser[b] = level[2 * b];
+            if (2 * b + 1 < level.size())
+                coarser[b].add(level[2 * b + 1]);
+        }
+        levels.push_back(std::move(level));
+        level = std::move(coarser);
+    }
+    levels.push_back(std::move(level));
+}
+
+SeriesPyramid::Extremes SeriesPyramid::query(size_t first, size_t last) const {
+    Extremes e = { values[first], values[first], first, first };
+    auto addSample = [&](size_t i) { e.add({ values[i], values[i], i, i }); };
+
+    // Unaligned samples at both ends one by one, the partial last bucket of
+    // the series counts as whole when the range runs to the end
+    size_t lo = first, hi = last;
+    while (lo < hi && lo % SERIES_BUCKET != 0) addSample(lo++);
+    if (hi != values.size())
+        while (hi > lo && hi % SERIES_BUCKET != 0) addSample(--hi);
+    if (lo >= hi)
+        return e;
+
+    // Buckets [i, j): take the unpaired ones at both ends, the rest is
+    // covered by half as many buckets of the next level
+    size_t i = lo / SERIES_BUCKET;
+    size_t j = (hi + SERIES_BUCKET - 1) / SERIES_BUCKET;
+    for (size_t l = 0; l < levels.size() && i < j; ++l) {
+        const std::vector<Extremes>& level = levels[l];
+        if (l + 1 == levels.size()) {
+            for (size_t k = i; k < j; ++k) e.add(level[k]);
+            break;
+        }
+        if (i % 2 == 1) e.add(level[i++]);
+        // An odd end is only unpaired if its partner exists
+        if (j % 2 == 1 && j != level.size() && i < j) e.add(level[--j]);
+        i /= 2;
+        j = (j + 1) / 2;
+    }
+    return e;
+}
+
+void SeriesPyramid::decimate(size_t first, size_t last, int xStart, int xEnd, float yOffset, float yScale,
+    std::vector<Point>& out) const {
+    out.clear();
+    last = std::min(last, values.size());
+    if (first >= last || xEnd < xStart)
+        return;
+
+    size_t count = last - first;
+    size_t columns = static_cast<size_t>(xEnd - xStart + 1);
+
+    // Sample i sits at its own x, so points stay in order across columns
+    float pixelsPerSample = count > 1 ? float(xEnd - xStart) / float(count - 1) : 0.0f;
+    auto point = [&](size_t i) {
+        return Point{ float(xStart) + float(i - first) * pixelsPerSample, yOffset + yScale * values[i] };
+    };
+
+    if (count <= 4 * columns) {
+        // Nothing to gain, M4 would keep about as many points
+        out.reserve(count);
+        for (size_t i = first; i < last; ++i)
+            out.push_back(point(i));
+        return;
+    }
+
+    out.reserve(4 * columns);
+    for (size_t c = 0; c < columns; ++c) {
+        // Samples whose x rounds to this column
+        size_t a = first + (c == 0 ? 0 : static_cast<size_t>(std::ceil((float(c) - 0.5f) / pixelsPerSample)));
+        size_t b = c + 1 == columns ? last : first + static_cast<size_t>(std::ceil((float(c) + 0.5f) / pixelsPerSample));
+        b = std::min(b, last);
+        if (a >= b)
+            continue;
+
+        Extremes e = query(a, b);
+        size_t lo = std::min(e.minIndex, e.maxIndex), hi = std::max(e.minIndex, e.maxIndex);
+        size_t order[4] = { a, lo, hi, b - 1 };
+        for (int k = 0; k < 4; ++k) {
+            if (k > 0 && order[k] == order[k - 1])
+                continue;
+            out.push_back(point(order[k]));
+        }
+    }
+}
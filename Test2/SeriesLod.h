@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "Polyline.h"
+
+// ---------- Level of detail for dense series ----------
+// A time series with far more samples than pixel columns is reduced M4
+// style before rasterization: every column keeps only its first, last,
+// minimum and maximum sample, in sample order. Drawn as a polyline it has
+// the same vertical extent in every column and the same joins between
+// columns as the full series, with at most 4 points per column.
+//
+// The minimum and maximum of a column come from a prebuilt pyramid of
+// per-bucket extremes, so a view costs O(columns * (SERIES_BUCKET + log n))
+// however many samples it spans and zooming is just a different lookup.
+
+static const size_t SERIES_BUCKET = 32; // samples per bucket of the finest level
+
+class SeriesPyramid {
+public:
+    // Build the levels over samples, which must outlive the pyramid
+    // Extra memory is about 1.5 bytes per sample.
+    void build(std::span<const float> samples);
+
+    size_t sampleCount() const { return values.size(); }
+
+    // Polyline of samples [first, last) drawn across the pixel columns
+    // xStart to xEnd, y = yOffset + yScale * sample, replacing out's contents.
+    // Views with fewer samples than columns are returned as they are.
+    void decimate(size_t first, size_t last, int xStart, int xEnd, float yOffset, float yScale,
+        std::vector<Point>& out) const;
+
+private:
+    // Extremes of a range of samples and where they are
+    struct Extremes {
+        float min, max;
+        uint64_t minIndex, maxIndex;
+
+        void add(const Extremes& e);
+    };
+
+    Extremes query(size_t first, size_t last) const;
+
+    std::span<const float> values;
+    std::vector<std::vector<Extremes>> levels; // level l buckets hold SERIES_BUCKET << l samples
+};
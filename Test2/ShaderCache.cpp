@@ -0,0 +1,275 @@
+#include "ShaderCache.h"
+#include "ShaderSources.h"
+
+#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Program binaries are GL 4.1 / ARB_get_program_binary, a GL 3.3 glad
+// loader does not provide them. We load them ourselves, like glBufferStorage.
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+typedef void (APIENTRY* GetProgramBinaryProc)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+typedef void (APIENTRY* ProgramBinaryProc)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+typedef void (APIENTRY* ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+static GetProgramBinaryProc getProgramBinary = nullptr;
+static ProgramBinaryProc programBinary = nullptr;
+static ProgramParameteriProc programParameteri = nullptr;
+
+static bool hasProgramBinary() {
+    static bool checked = false;
+    if (!checked) {
+        checked = true;
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool supported = (major > 4 || (major == 4 && minor >= 1)) ||
+            glfwExtensionSupported("GL_ARB_get_program_binary");
+
+        // Some drivers expose the entry points but no format to save in
+        GLint formats = 0;
+        if (supported)
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+        if (supported && formats > 0) {
+            getProgramBinary = (GetProgramBinaryProc)glfwGetProcAddress("glGetProgramBinary");
+            programBinary = (ProgramBinaryProc)glfwGetProcAddress("glProgramBinary");
+            programParameteri = (ProgramParameteriProc)glfwGetProcAddress("glProgramParameteri");
+        }
+    }
+    return getProgramBinary && programBinary && programParameteri;
+}
+
+// ---------- Compile and link ----------
+
+const char* embeddedShaderSource(const char* name) {
+    for (const EmbeddedShader& shader : EMBEDDED_SHADERS)
+        if (std::strcmp(shader.name, name) == 0)
+            return shader.source;
+    return nullptr;
+}
+
+static std::string shaderInfoLog(GLuint shader) {
+    GLint length = 0;
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+    std::string log(length > 0 ? length : 0, '\0');
+    if (length > 0)
+        glGetShaderInfoLog(shader, length, nullptr, log.data());
+    return log;
+}
+
+static std::string programInfoLog(GLuint program) {
+    GLint length = 0;
+    glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+    std::string log(length > 0 ? length : 0, '\0');
+    if (length > 0)
+        glGetProgramInfoLog(program, length, nullptr, log.data());
+    return log;
+}
+
+GLuint compileShader(GLenum type, const char* source, const char* name) {
+    GLuint shader = glCreateShader(type);
+    glShaderSource(shader, 1, &source, NULL);
+    glCompileShader(shader);
+
+    GLint status = GL_FALSE;
+    glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
+    if (status != GL_TRUE) {
+        std::cerr << "ERROR: Could not compile " << name << ":\n" << shaderInfoLog(shader) << std::endl;
+        glDeleteShader(shader);
+        return 0;
+    }
+    return shader;
+}
+
+// Compile and link, optionally asking the driver to keep the binary retrievable
+static GLuint linkProgram(const char* vertexName, const char* fragmentName, bool retrievable) {
+    const char* vertexSource = embeddedShaderSource(vertexName);
+    const char* fragmentSource = embeddedShaderSource(fragmentName);
+    if (!vertexSource || !fragmentSource) {
+        std::cerr << "ERROR: No embedded shader " << (vertexSource ? fragmentName : vertexName)
+            << " (regenerate ShaderSources.h with embed_shaders.ps1)" << std::endl;
+        return 0;
+    }
+
+    GLuint vertexShader = compileShader(GL_VERTEX_SHADER, vertexSource, vertexName);
+    GLuint fragmentShader = compileShader(GL_FRAGMENT_SHADER, fragmentSource, fragmentName);
+    if (!vertexShader || !fragmentShader) {
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    if (retrievable)
+        programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glAttachShader(program, vertexShader);
+    glAttachShader(program, fragmentShader);
+    glLinkProgram(program);
+
+    glDetachShader(program, vertexShader);
+    glDetachShader(program, fragmentShader);
+    glDeleteShader(vertexShader);
+    glDeleteShader(fragmentShader);
+
+    GLint status = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &status);
+    if (status != GL_TRUE) {
+        std::cerr << "ERROR: Could not link " << vertexName << " + " << fragmentName << ":\n"
+            << programInfoLog(program) << std::endl;
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+GLuint createShaderProgram(const char* vertexName, const char* fragmentName) {
+    return linkProgram(vertexName, fragmentName, false);
+}
+
+// ---------- Program binary cache ----------
+
+// File layout: header, driver string, binary
+struct ProgramCacheHeader {
+    char magic[4];         // "WUPB"
+    uint32_t format;       // binaryFormat of glGetProgramBinary
+    uint64_t sourceHash;   // both sources, see sourceHash()
+    uint32_t driverLength; // bytes of the driver string that follows
+    uint32_t binaryLength;
+};
+
+// FNV-1a over both sources, the separator keeps "ab" + "c" apart from "a" + "bc"
+static uint64_t sourceHash(const char* vertexSource, const char* fragmentSource) {
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&](const char* s, size_t length) {
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= static_cast<unsigned char>(s[i]);
+            hash *= 1099511628211ull;
+        }
+    };
+    add(vertexSource, std::strlen(vertexSource));
+    add("", 1);
+    add(fragmentSource, std::strlen(fragmentSource));
+    return hash;
+}
+
+static std::string glString(GLenum name) {
+    const GLubyte* s = glGetString(name);
+    return s ? reinterpret_cast<const char*>(s) : "";
+}
+
+std::string defaultShaderCacheDirectory() {
+    if (const char* dir = std::getenv("SHADER_CACHE_DIR"))
+        return dir;
+    return "shader_cache";
+}
+
+void ProgramCache::init(const std::string& cacheDirectory) {
+    directory = cacheDirectory;
+    enabled = false;
+    if (directory.empty() || !hasProgramBinary())
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if (error) {
+        std::cerr << "ERROR: Could not create shader cache " << directory << ": " << error.message() << std::endl;
+        return;
+    }
+
+    driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+    enabled = true;
+}
+
+GLuint ProgramCache::load(const char* vertexName, const char* fragmentName) {
+    if (!enabled)
+        return createShaderProgram(vertexName, fragmentName);
+
+    const char* vertexSource = embeddedShaderSource(vertexName);
+    const char* fragmentSource = embeddedShaderSource(fragmentName);
+    if (!vertexSource || !fragmentSource)
+        return createShaderProgram(vertexName, fragmentName); // reports the missing one
+
+    uint64_t hash = sourceHash(vertexSource, fragmentSource);
+    std::filesystem::path path = std::filesystem::path(directory) /
+        (std::filesystem::path(vertexName).stem().string() + "+" + std::filesystem::path(fragmentName).stem().string() + ".bin");
+
+    // ---------- Cached binary ----------
+    // Anything that doesn't match is a miss, the file is rewritten below
+    {
+        std::error_code error;
+        uintmax_t fileSize = std::filesystem::file_size(path, error);
+        std::ifstream in(path, std::ios::binary);
+        ProgramCacheHeader header;
+        if (!error && in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+            std::memcmp(header.magic, "WUPB", 4) == 0 && header.sourceHash == hash &&
+            header.driverLength == driver.size() &&
+            fileSize == sizeof(header) + uintmax_t(header.driverLength) + header.binaryLength) {
+            std::string fileDriver(header.driverLength, '\0');
+            std::vector<char> binary(header.binaryLength);
+            if (in.read(fileDriver.data(), fileDriver.size()) && fileDriver == driver &&
+                in.read(binary.data(), binary.size())) {
+                GLuint program = glCreateProgram();
+                programBinary(program, header.format, binary.data(), static_cast<GLsizei>(binary.size()));
+                GLint status = GL_FALSE;
+                glGetProgramiv(program, GL_LINK_STATUS, &status);
+                if (status == GL_TRUE)
+                    return program;
+                glDeleteProgram(program); // rejected, e.g. a driver update with the same version string
+            }
+        }
+    }
+
+    // ---------- Compile, link and save ----------
+    GLuint program = linkProgram(vertexName, fragmentName, true);
+    if (!program)
+        return 0;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return program;
+
+    std::vector<char> binary(length);
+    GLenum format = 0;
+    getProgramBinary(program, length, &length, &format, binary.data());
+
+    ProgramCacheHeader header = {};
+    std::memcpy(header.magic, "WUPB", 4);
+    header.format = format;
+    header.sourceHash = hash;
+    header.driverLength = static_cast<uint32_t>(driver.size());
+    header.binaryLength = static_cast<uint32_t>(length);
+
+    // Written under a name of its own and renamed, so processes starting at
+    // the same time never read or write a half-written file
+    std::filesystem::path temporary = path;
+    temporary += "." + std::to_string(std::random_device{}()) + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(driver.data(), driver.size());
+        out.write(binary.data(), length);
+        if (!out)
+            std::cerr << "ERROR: Could not write shader cache " << temporary.string() << std::endl;
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    if (error)
+        std::filesystem::remove(temporary, error); // another process got there first, its file is as good
+    return program;
+}
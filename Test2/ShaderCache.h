@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// ---------- Shader programs ----------
+// Shaders come from the sources embedded at build time (ShaderSources.h,
+// generated from the .glsl files), so nothing depends on the working
+// directory. Compile and link failures print an ERROR with the info log
+// and return 0 instead of handing out a program that draws nothing.
+
+// Embedded source of a .glsl file by name, nullptr if there is none
+const char* embeddedShaderSource(const char* name);
+
+// Compile one shader, 0 on failure (name is only for the messages)
+GLuint compileShader(GLenum type, const char* source, const char* name);
+
+// Compile and link a program from two embedded shaders, 0 on failure
+GLuint createShaderProgram(const char* vertexName, const char* fragmentName);
+
+// ---------- Program binary cache ----------
+// Linked programs are saved with glGetProgramBinary and loaded back with
+// glProgramBinary on the next start, skipping compile and link. A binary
+// is only valid for the driver that produced it: every file records the
+// GL vendor, renderer and version strings and a hash of both sources, and
+// is ignored and rewritten when any of them differs or the driver rejects it.
+//
+// Needs GL 4.1 or ARB_get_program_binary with at least one binary format,
+// without it every load() compiles from source.
+class ProgramCache {
+public:
+    // directory holds one file per program, created if missing
+    // An empty directory disables the cache.
+    void init(const std::string& directory);
+
+    // Same as createShaderProgram, from the cache when it has this program
+    GLuint load(const char* vertexName, const char* fragmentName);
+
+    bool isEnabled() const { return enabled; }
+
+private:
+    std::string directory;
+    std::string driver; // vendor, renderer and version the binaries must match
+    bool enabled = false;
+};
+
+// Cache directory: $SHADER_CACHE_DIR if set (empty disables the cache),
+// otherwise shader_cache in the working directory
+std::string defaultShaderCacheDirectory();
@@ -0,0 +1,542 @@
+// Generated by embed_shaders.ps1 from the .glsl files in this directory, do not edit
+// The .glsl files are the sources, the pre-build event regenerates this header.
+#pragma once
+
+struct EmbeddedShader {
+    const char* name;   // file name of the source
+    const char* source;
+};
+
+constexpr EmbeddedShader EMBEDDED_SHADERS[] = {
+    { "fragment_shader.glsl", R"glsl(#version 330 core
+
+in vec4 vColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Weight; // coverage weight, only CoverageBuffer keeps it
+
+void main()
+{
+    FragColor = vColor;
+    Weight = vec4(1.0, 0.0, 0.0, vColor.a);
+})glsl" },
+    { "gpu_line_quad_fragment_shader.glsl", R"glsl(#version 330 core
+// Wu coverage of the quad path, evaluated per target pixel
+// In the main loop Wu gives the pixel at minor offset n of column m the
+// coverage 1 - |y(m) - n| (clamped at 0): the floor pixel gets 1 - fpart(y),
+// the one above fpart(y), everything else nothing. The endpoint columns use
+// yend and are scaled by xgap, as in xiaolinWuLine.
+// That is the overlap of the pixel with a band one pixel thick around the
+// line, so thicker lines (vWidth, see scene_vertex_shader.glsl) widen the band.
+//
+// A fragment can cover several target pixels (the demo draws the target into
+// half-size cells), so every target pixel whose center is inside the fragment
+// contributes, combined the way their points would have been blended.
+
+flat in vec4 vLine;
+flat in int vSteep;
+flat in vec4 vColor;
+flat in float vWidth;
+in vec2 vPixel;
+
+uniform int combine; // 0 = alpha blended, 1 = max, 2 = additive (see CoverageBuffer)
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Weight; // coverage weight, only CoverageBuffer keeps it
+
+float wuCoverage(vec2 pixel) {
+    float x0 = vLine.x, y0 = vLine.y, x1 = vLine.z, y1 = vLine.w;
+    float major = vSteep == 1 ? pixel.y : pixel.x;
+    float minor = vSteep == 1 ? pixel.x : pixel.y;
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    if (major < xpxl1 || major > xpxl2)
+        return 0.0;
+
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+    float y, xgap = 1.0;
+    if (major == xpxl1) {
+        y = yend1;
+        xgap = 1.0 - (x0 - xpxl1);
+    }
+    else if (major == xpxl2) {
+        y = y1 + gradient * (xpxl2 - x1);
+        xgap = 1.0 - (x1 - xpxl2);
+    }
+    else {
+        y = yend1 + gradient * (major - xpxl1);
+    }
+    // Overlap of [y - w/2, y + w/2] with the pixel [minor - 0.5, minor + 0.5],
+    // 1 - |y - minor| for w = 1
+    float halfWidth = 0.5 * vWidth;
+    float overlap = min(y + halfWidth, minor + 0.5) - max(y - halfWidth, minor - 0.5);
+    return clamp(overlap * xgap, 0.0, 1.0);
+}
+
+void main() {
+    // Target pixels with their center inside this fragment, at most 4 per axis
+    vec2 footprint = max(fwidth(vPixel), vec2(1.0));
+    vec2 first = ceil(vPixel - 0.5 * footprint);
+    vec2 last = ceil(vPixel + 0.5 * footprint) - 1.0;
+
+    float transmit = 1.0, maxCoverage = 0.0, sum = 0.0;
+    for (int j = 0; j < 4; ++j) {
+        float py = first.y + float(j);
+        if (py > last.y) break;
+        for (int i = 0; i < 4; ++i) {
+            float px = first.x + float(i);
+            if (px > last.x) break;
+            float c = wuCoverage(vec2(px, py));
+            transmit *= 1.0 - c;
+            maxCoverage = max(maxCoverage, c);
+            sum += c;
+        }
+    }
+
+    float coverage = (combine == 1 ? maxCoverage : combine == 2 ? sum : 1.0 - transmit) * vColor.a;
+    if (coverage <= 0.0)
+        discard;
+    FragColor = vec4(vColor.rgb, coverage);
+    Weight = vec4(1.0, 0.0, 0.0, coverage);
+}
+)glsl" },
+    { "gpu_line_quad_vertex_shader.glsl", R"glsl(#version 330 core
+// GPU Wu lines as one quad per segment instead of one point per pixel.
+// The 4 vertices of an instance (a triangle strip) are the corners of the
+// band around the line that holds every pixel Wu plots: the columns from
+// floor(x0) to ceil(x1) and 2 pixels either side of the line, sheared along
+// it. gpu_line_quad_fragment_shader.glsl works out each pixel's coverage.
+// Instances come in pairs (divisor 2), one per cell, like gpu_line_vertex_shader.glsl.
+layout (location = 0) in vec4 aLine; // x0, y0, x1, y1 (pixels)
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+uniform vec3 lineColor;
+
+flat out vec4 vLine;  // major/minor endpoints after the steep swap, x0 <= x1
+flat out int vSteep;
+flat out vec4 vColor; // rgb, opacity
+flat out float vWidth; // minor-axis thickness, 1 = Wu's line
+out vec2 vPixel;      // target pixel coordinates, pixel p is centered on p
+
+void main() {
+    float x0 = aLine.x, y0 = aLine.y, x1 = aLine.z, y1 = aLine.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = aLine.y; y0 = aLine.x; x1 = aLine.w; y1 = aLine.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+
+    // Half a pixel past the endpoint columns, 2 pixels above and below the line:
+    // Wu's two pixels reach 1.5 from it and a sample can sit half a pixel off center
+    int corner = gl_VertexID;
+    float major = corner < 2 ? xpxl1 - 0.5 : xpxl2 + 0.5;
+    float minor = yend1 + gradient * (major - xpxl1) + (corner % 2 == 0 ? -2.0 : 2.0);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    vPixel = pixel;
+    vLine = vec4(x0, y0, x1, y1);
+    vSteep = steep ? 1 : 0;
+    vColor = vec4(lineColor, 1.0);
+    vWidth = 1.0;
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID % 2;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+}
+)glsl" },
+    { "gpu_line_vertex_shader.glsl", R"glsl(#version 330 core
+// GPU line backend: only the line endpoints are uploaded, every vertex of
+// a draw rasterizes one pixel of its line from gl_VertexID.
+// Instances come in pairs (divisor 2), one per cell of the algorithm.
+layout (location = 0) in vec4 aLine; // x0, y0, x1, y1 (pixels)
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform int lineMode;    // 0 = Bresenham, 1 = Xiaolin Wu
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+uniform vec3 lineColor;  // Wu color
+
+out vec4 vColor;
+
+// Matches std::round on the CPU (half away from zero), GLSL round() doesn't specify ties
+float roundHalfAway(float v) {
+    return sign(v) * floor(abs(v) + 0.5);
+}
+
+float fpart(float x) { return x - floor(x); }
+float rfpart(float x) { return 1.0 - fpart(x); }
+
+// Vertices past the end of a shorter line are clipped away
+void cull() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+    gl_ClipDistance[0] = -1.0;
+    gl_ClipDistance[1] = -1.0;
+    gl_ClipDistance[2] = -1.0;
+    gl_ClipDistance[3] = -1.0;
+    vColor = vec4(0.0);
+}
+
+void emit(vec2 pixel, vec4 color) {
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID % 2;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : color;
+}
+
+// Pixel i of the integer Bresenham line. The error-term loop on the CPU
+// always steps the major axis and puts the minor axis at
+// (2 * i * minor + major) / (2 * major), which is what we compute directly.
+void bresenham() {
+    ivec2 p0 = ivec2(roundHalfAway(aLine.x), roundHalfAway(aLine.y));
+    ivec2 p1 = ivec2(roundHalfAway(aLine.z), roundHalfAway(aLine.w));
+
+    int adx = abs(p1.x - p0.x);
+    int ady = abs(p1.y - p0.y);
+    int sx = p0.x < p1.x ? 1 : -1;
+    int sy = p0.y < p1.y ? 1 : -1;
+    int major = max(adx, ady);
+
+    int i = gl_VertexID;
+    if (i > major) { cull(); return; }
+
+    int f = major == 0 ? 0 : (2 * i * min(adx, ady) + major) / (2 * major);
+    ivec2 p = adx >= ady ? ivec2(p0.x + sx * i, p0.y + sy * f)
+                         : ivec2(p0.x + sx * f, p0.y + sy * i);
+
+    emit(vec2(p), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+// Two vertices per column: column 0 and 1 are the endpoints, then the main loop.
+// Same setup as xiaolinWuLine, but intery is evaluated in closed form per column.
+void xiaolinWu() {
+    float x0 = aLine.x, y0 = aLine.y, x1 = aLine.z, y1 = aLine.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = aLine.y; y0 = aLine.x; x1 = aLine.w; y1 = aLine.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float gradient = (dx == 0.0) ? 1.0 : (dy / dx);
+
+    int column = gl_VertexID / 2;
+    int upper = gl_VertexID % 2; // 0 = floor pixel, 1 = the one above
+
+    float xpxl1 = floor(x0);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+    float xpxl2 = ceil(x1);
+
+    float major, y, coverage;
+    if (column == 0) {
+        major = xpxl1;
+        y = yend1;
+        coverage = 1.0 - (x0 - xpxl1);
+    }
+    else if (column == 1) {
+        major = xpxl2;
+        y = y1 + gradient * (xpxl2 - x1);
+        coverage = 1.0 - (x1 - xpxl2);
+    }
+    else {
+        int x = int(xpxl1) + 1 + (column - 2);
+        if (x >= int(xpxl2)) { cull(); return; }
+        major = float(x);
+        y = yend1 + gradient * (major - xpxl1);
+        coverage = 1.0;
+    }
+
+    float minor = floor(y) + float(upper);
+    coverage *= upper == 1 ? fpart(y) : rfpart(y);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    emit(pixel, vec4(lineColor, coverage));
+}
+
+void main() {
+    if (lineMode == 0)
+        bresenham();
+    else
+        xiaolinWu();
+}
+)glsl" },
+    { "packed_vertex_shader.glsl", R"glsl(#version 330 core
+// Packed Wu vertices: integer pixel coordinates and 8-bit coverage
+layout (location = 0) in vec2 aPixel;    // int16 x, y (pixels)
+layout (location = 1) in vec2 aCoverage; // uint8 coverage, uint8 color index
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform mat4 pixelToNdc;       // glm::ortho of the target the coordinates are relative to
+uniform vec3 lineColors[16];   // per-draw color table
+
+out vec4 vColor;
+
+void main() {
+    // Pixel center to NDC, done here instead of per pixel on the CPU
+    vec2 ndc = (pixelToNdc * vec4(aPixel, 0.0, 1.0)).xy;
+
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = vec4(lineColors[int(aCoverage.y)], aCoverage.x / 255.0);
+})glsl" },
+    { "resolve_fragment_shader.glsl", R"glsl(#version 330 core
+// Coverage resolve: the accumulation buffer holds the premultiplied line
+// colors summed in rgb and the accumulated coverage in alpha, the weight
+// buffer the summed coverage. rgb / weight is the coverage-weighted mean
+// color, blended over the cleared cells.
+uniform sampler2D coverage;
+uniform sampler2D weight;
+
+out vec4 FragColor;
+
+void main()
+{
+    vec4 accumulated = texelFetch(coverage, ivec2(gl_FragCoord.xy), 0);
+    float total = texelFetch(weight, ivec2(gl_FragCoord.xy), 0).r;
+    vec3 color = total > 0.0 ? accumulated.rgb / total : vec3(0.0);
+    FragColor = vec4(color, clamp(accumulated.a, 0.0, 1.0));
+}
+)glsl" },
+    { "resolve_vertex_shader.glsl", R"glsl(#version 330 core
+// Full-screen triangle from gl_VertexID, no vertex buffer needed
+
+void main() {
+    vec2 pos = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    gl_Position = vec4(pos, 0.0, 1.0);
+}
+)glsl" },
+    { "scene_vertex_shader.glsl", R"glsl(#version 330 core
+// LineScene: Wu quads of many lines with per-line style, no vertex attributes
+// Every line is 12 vertices, two triangles per cell for both cells, so
+// gl_VertexID gives the line ID and one glMultiDrawArrays draws any set of
+// line ranges. Endpoints and style are fetched from buffer textures by ID.
+// The quad is the one of gpu_line_quad_vertex_shader.glsl, widened for
+// thick lines, and shares gpu_line_quad_fragment_shader.glsl.
+
+uniform samplerBuffer lineEndpoints; // RGBA32F: x0, y0, x1, y1 (pixels)
+uniform samplerBuffer lineColors;    // RGBA8: rgb, opacity
+uniform samplerBuffer lineWidths;    // R32F: minor-axis thickness
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+
+flat out vec4 vLine;  // major/minor endpoints after the steep swap, x0 <= x1
+flat out int vSteep;
+flat out vec4 vColor; // rgb, opacity
+flat out float vWidth;
+out vec2 vPixel;      // target pixel coordinates, pixel p is centered on p
+
+// Strip corners of the quad as two triangles
+const int CORNERS[6] = int[6](0, 1, 2, 2, 1, 3);
+
+void main() {
+    int id = gl_VertexID / 12;
+    int local = gl_VertexID % 12;
+    int corner = CORNERS[local % 6];
+
+    vec4 line = texelFetch(lineEndpoints, id);
+    float width = texelFetch(lineWidths, id).r;
+
+    float x0 = line.x, y0 = line.y, x1 = line.z, y1 = line.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = line.y; y0 = line.x; x1 = line.w; y1 = line.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+
+    // Half a pixel past the endpoint columns and far enough above and below
+    // the line for the band plus a sample half a pixel off center
+    float reach = max(2.0, 0.5 * width + 1.5);
+    float major = corner < 2 ? xpxl1 - 0.5 : xpxl2 + 0.5;
+    float minor = yend1 + gradient * (major - xpxl1) + (corner % 2 == 0 ? -reach : reach);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    vPixel = pixel;
+    vLine = vec4(x0, y0, x1, y1);
+    vSteep = steep ? 1 : 0;
+    vColor = texelFetch(lineColors, id);
+    vWidth = width;
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + local / 6;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+}
+)glsl" },
+    { "sine_vertex_shader.glsl", R"glsl(#version 330 core
+// GPU sine backend: only the pixel columns are uploaded (once), the curve
+// is evaluated here from time, so an animated frame uploads nothing.
+// Every column is stored twice, Wu reads both copies (floor and upper pixel),
+// Bresenham reads every second one.
+layout (location = 0) in float aColumn; // pixel x
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform int lineMode;    // 0 = Bresenham, 1 = Xiaolin Wu
+uniform vec2 targetSize; // pixel size of the target
+uniform float amplitude; // pixels
+uniform float frequency; // controls wavelength
+uniform float time;      // phase
+uniform vec3 lineColor;  // Wu color
+
+out vec4 vColor;
+
+void main() {
+    float x = aColumn;
+    float y = floor(targetSize.y / 2.0) + amplitude * sin(frequency * x + time);
+
+    vec2 pixel;
+    float coverage = 1.0;
+    if (lineMode == 0) {
+        // Bresenham: just pixel centers (one vertex per column)
+        pixel = vec2(x, y);
+    }
+    else {
+        // Wu: use floor + fractional part (dont round)
+        int upper = gl_VertexID % 2; // 0 = floor pixel, 1 = the one above
+        float frac = y - floor(y);
+        pixel = vec2(x, floor(y) + float(upper));
+        coverage = upper == 1 ? frac : 1.0 - frac;
+    }
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : vec4(lineColor, coverage);
+}
+)glsl" },
+    { "vertex_shader.glsl", R"glsl(#version 330 core
+layout (location = 0) in vec2 aPos;
+layout (location = 1) in vec4 aColor;
+
+// One entry per viewport cell, selected by cellOffset + gl_InstanceID
+// rect is the cell in window NDC (x0, y0, x1, y1)
+// color is the constant color used when useCellColor is set
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform mat4 pixelToNdc; // identity for NDC input, glm::ortho for pixel input
+
+out vec4 vColor;
+
+void main() {
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    // The one pixel -> NDC transform, the rasterizers can skip theirs
+    vec2 ndc = (pixelToNdc * vec4(aPos, 0.0, 1.0)).xy;
+
+    // Map the cell-local NDC position into the cell rectangle
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    // Clip against the cell edges, like a per-cell glViewport would
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : aColor;
+})glsl" },
+};
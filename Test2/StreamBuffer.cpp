@@ -0,0 +1,178 @@
+#include "StreamBuffer.h"
+
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+
+// glBufferStorage is GL 4.4, so a GL 3.3 glad loader does not provide it.
+// We load it ourselves and only use it when the context supports it.
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void (APIENTRY* BufferStorageProc)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+static BufferStorageProc bufferStorage = nullptr;
+
+static bool hasBufferStorage() {
+    static bool checked = false;
+    if (!checked) {
+        checked = true;
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        bool supported = (major > 4 || (major == 4 && minor >= 4)) ||
+            glfwExtensionSupported("GL_ARB_buffer_storage");
+        if (supported)
+            bufferStorage = (BufferStorageProc)glfwGetProcAddress("glBufferStorage");
+    }
+    return bufferStorage != nullptr;
+}
+
+void StreamBuffer::init(GLsizei vertexStride, GLsizei vertexCapacity) {
+    stride = vertexStride;
+    capacity = vertexCapacity > 0 ? vertexCapacity : 1;
+    persistent = hasBufferStorage();
+    createStorage();
+}
+
+void StreamBuffer::destroy() {
+    releaseStorage();
+    stride = 0;
+    capacity = 0;
+}
+
+bool StreamBuffer::reserve(GLsizei count) {
+    if (count <= capacity)
+        return false;
+
+    // Grow geometrically so a slowly growing scene doesn't recreate every frame
+    GLsizei newCapacity = capacity * 2;
+    if (newCapacity < count) newCapacity = count;
+
+    releaseStorage();
+    capacity = newCapacity;
+    createStorage();
+    return true;
+}
+
+void StreamBuffer::beginFrame() {
+    if (persistent) {
+        segment = (segment + 1) % FRAME_COUNT;
+        waitFence(segment);
+    }
+    head = 0;
+}
+
+void* StreamBuffer::map(GLsizei count, GLint& first) {
+    first = 0;
+    if (count <= 0)
+        return nullptr; // nothing to write (and a zero-length map is a GL error)
+    if (head + count > capacity) {
+        std::cerr << "ERROR: StreamBuffer overflow (" << head + count << " > " << capacity << " vertices)" << std::endl;
+        return nullptr;
+    }
+
+    first = segment * capacity + head;
+    GLsizei start = head;
+    head += count;
+
+    if (persistent)
+        return base + static_cast<size_t>(first) * stride;
+
+    // Fallback: the first map of a frame orphans the old storage, later maps
+    // write to fresh ranges of the same storage without synchronizing.
+    GLbitfield access = GL_MAP_WRITE_BIT;
+    access |= (start == 0) ? GL_MAP_INVALIDATE_BUFFER_BIT : (GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    void* ptr = glMapBufferRange(GL_ARRAY_BUFFER,
+        static_cast<GLintptr>(start) * stride,
+        static_cast<GLsizeiptr>(count) * stride,
+        access);
+    mapped = (ptr != nullptr);
+    return ptr;
+}
+
+void StreamBuffer::unmap() {
+    if (persistent || !mapped)
+        return;
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    mapped = false;
+}
+
+void StreamBuffer::endFrame() {
+    if (!persistent)
+        return;
+    if (fences[segment])
+        glDeleteSync(fences[segment]);
+    fences[segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void StreamBuffer::createStorage() {
+    glGenBuffers(1, &vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+    if (persistent) {
+        GLsizeiptr size = static_cast<GLsizeiptr>(capacity) * stride * FRAME_COUNT;
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+        base = static_cast<unsigned char*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+        if (base == nullptr) {
+            // Driver refused the persistent mapping, use orphaning instead
+            std::cerr << "WARNING: persistent mapping failed, falling back to orphaning" << std::endl;
+            glDeleteBuffers(1, &vbo);
+            persistent = false;
+            createStorage();
+            return;
+        }
+    }
+    else {
+        GLsizeiptr size = static_cast<GLsizeiptr>(capacity) * stride;
+        glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STREAM_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    segment = 0;
+    head = 0;
+}
+
+void StreamBuffer::releaseStorage() {
+    for (int i = 0; i < FRAME_COUNT; ++i) {
+        if (fences[i]) {
+            glDeleteSync(fences[i]);
+            fences[i] = nullptr;
+        }
+    }
+    if (vbo) {
+        if (base || mapped) {
+            glBindBuffer(GL_ARRAY_BUFFER, vbo);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &vbo);
+        vbo = 0;
+    }
+    base = nullptr;
+    mapped = false;
+}
+
+void StreamBuffer::waitFence(int index) {
+    GLsync fence = fences[index];
+    if (!fence)
+        return;
+
+    // Flush on the first wait so the fence is guaranteed to signal
+    GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+    while (true) {
+        GLenum result = glClientWaitSync(fence, flags, 1000000); // 1 ms
+        if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+            break;
+        flags = 0;
+    }
+    glDeleteSync(fence);
+    fences[index] = nullptr;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <glad/glad.h>
+
+// Streaming vertex buffer for per-frame uploads
+// The buffer is split into FRAME_COUNT segments, one per frame in flight.
+// Each frame writes into its own segment and places a fence after its draws,
+// so the CPU only waits when it catches up with a frame the GPU is still drawing.
+//
+// On GL 4.4 / ARB_buffer_storage the whole buffer is persistently mapped once.
+// On plain GL 3.3 it falls back to orphaning with glMapBufferRange.
+class StreamBuffer {
+public:
+    static const int FRAME_COUNT = 3; // triple buffered
+
+    // stride: size of one vertex in bytes, capacity: vertices per frame
+    void init(GLsizei stride, GLsizei capacity);
+    void destroy();
+
+    // Grow the per-frame capacity to hold at least count vertices
+    // Returns true if the GL buffer was recreated (attribute pointers must be set again)
+    // Recreating drops this frame's slices, so call it before the frame's first map().
+    bool reserve(GLsizei count);
+
+    // Start a new frame: advance to the next segment and wait for its fence
+    void beginFrame();
+
+    // Reserve count vertices in this frame's segment and return a write pointer.
+    // first receives the vertex index to pass to glDrawArrays.
+    // Returns nullptr if the segment is full (call reserve() first).
+    // The memory is write only, it must not be read back.
+    void* map(GLsizei count, GLint& first);
+
+    // Finish writing the range returned by map (no-op when persistently mapped)
+    void unmap();
+
+    // Fence this frame's segment once all draws reading from it are submitted
+    void endFrame();
+
+    GLuint buffer() const { return vbo; }
+    bool isPersistent() const { return persistent; }
+
+private:
+    void createStorage();
+    void releaseStorage();
+    void waitFence(int index);
+
+    GLuint vbo = 0;
+    GLsizei stride = 0;
+    GLsizei capacity = 0;   // vertices per segment
+    GLsizei head = 0;       // vertices used in the current segment
+    int segment = 0;
+    bool persistent = false;
+    bool mapped = false;    // fallback path: a range is currently mapped
+    unsigned char* base = nullptr; // persistent mapping of the whole buffer
+    GLsync fences[FRAME_COUNT] = {};
+};
@@ -0,0 +1,104 @@
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0)
+        threadCount = std::thread::hardware_concurrency();
+    if (threadCount == 0)
+        threadCount = 1;
+
+    queues = std::make_unique<ChunkQueue[]>(threadCount);
+
+    // Index 0 is the thread calling parallelFor
+    for (unsigned i = 1; i < threadCount; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers)
+        worker.join();
+}
+
+void ThreadPool::parallelFor(size_t itemCount, size_t itemGrain, const std::function<void(size_t, size_t)>& loopBody) {
+    if (itemCount == 0)
+        return;
+    if (itemGrain == 0)
+        itemGrain = 1;
+
+    size_t chunkCount = (itemCount + itemGrain - 1) / itemGrain;
+
+    // Not worth waking anyone up
+    if (workers.empty() || chunkCount == 1) {
+        loopBody(0, itemCount);
+        return;
+    }
+
+    // Deal out contiguous runs of chunks, thread i gets [i * n / T, (i + 1) * n / T)
+    unsigned threadCount = size();
+    for (unsigned i = 0; i < threadCount; ++i) {
+        queues[i].next.store(chunkCount * i / threadCount, std::memory_order_relaxed);
+        queues[i].end = chunkCount * (i + 1) / threadCount;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        body = &loopBody;
+        count = itemCount;
+        grain = itemGrain;
+        running = static_cast<unsigned>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [&] { return running == 0; });
+    body = nullptr;
+}
+
+void ThreadPool::workerLoop(unsigned index) {
+    unsigned long long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping)
+                return;
+            seen = generation;
+        }
+
+        runChunks(index);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--running == 0)
+            finished.notify_one();
+    }
+}
+
+void ThreadPool::runChunks(unsigned index) {
+    unsigned threadCount = size();
+
+    // Own run first, then steal from the others in order
+    for (unsigned k = 0; k < threadCount; ++k) {
+        ChunkQueue& queue = queues[(index + k) % threadCount];
+        while (true) {
+            size_t chunk = queue.next.fetch_add(1, std::memory_order_relaxed);
+            if (chunk >= queue.end)
+                break;
+
+            size_t begin = chunk * grain;
+            size_t end = begin + grain < count ? begin + grain : count;
+            (*body)(begin, end);
+        }
+    }
+}
+
+ThreadPool& defaultThreadPool() {
+    static ThreadPool pool;
+    return pool;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size pool for data-parallel loops
+// parallelFor splits [0, count) into chunks and gives every thread (the caller
+// included) a contiguous run of them. Threads take chunks from their own run
+// with one atomic increment and steal from the others' runs the same way once
+// theirs is empty, so no lock is taken while the loop body runs.
+class ThreadPool {
+public:
+    // threadCount includes the calling thread, 0 = hardware_concurrency
+    explicit ThreadPool(unsigned threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    unsigned size() const { return static_cast<unsigned>(workers.size()) + 1; }
+
+    // Runs body(begin, end) over [0, count) in chunks of at most grain items
+    // and returns once every chunk is done. Not reentrant.
+    void parallelFor(size_t count, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+private:
+    // One run of chunk indices per thread, padded to avoid false sharing
+    struct alignas(64) ChunkQueue {
+        std::atomic<size_t> next{ 0 };
+        size_t end = 0;
+    };
+
+    void workerLoop(unsigned index);
+    void runChunks(unsigned index);
+
+    std::vector<std::thread> workers;
+    std::unique_ptr<ChunkQueue[]> queues;
+
+    // Current job, published under mutex, read lock-free while running
+    const std::function<void(size_t, size_t)>* body = nullptr;
+    size_t count = 0;
+    size_t grain = 1;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+    unsigned long long generation = 0;
+    unsigned running = 0;
+    bool stopping = false;
+};
+
+// Shared pool used by the batch rasterizer
+ThreadPool& defaultThreadPool();
@@ -0,0 +1,113 @@
+#include "TileRasterizer.h"
+#include "Framebuffer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Tiles per chunk handed to a thread
+static const size_t TILE_GRAIN = 4;
+
+// How far a line's pixels reach past the line itself: Wu covers the endpoint
+// columns (floor / ceil of the endpoints) and the pixel above the line,
+// Bresenham rounds its endpoints
+static const float TILE_REACH = 2.0f;
+
+static int roundPixel(float v) {
+    return static_cast<int>(std::round(v));
+}
+
+struct TileGrid {
+    int tileSize;
+    int columns, rows;
+};
+
+// Calls visit(tile index) once for every tile the line can touch
+// The line is cut into tile-column bands, inside a band it spans a y range
+// that gives the tile rows. Conservative by TILE_REACH, an extra tile only
+// finds nothing when it clips the line.
+template <typename Visit>
+static void forEachTile(const Line& line, const TileGrid& grid, Visit&& visit) {
+    float size = static_cast<float>(grid.tileSize);
+    float x0 = line.x0, y0 = line.y0, x1 = line.x1, y1 = line.y1;
+    if (!clipLine(x0, y0, x1, y1, -TILE_REACH, -TILE_REACH,
+            grid.columns * size + TILE_REACH, grid.rows * size + TILE_REACH))
+        return;
+
+    float dx = x1 - x0, dy = y1 - y0;
+    int firstColumn = std::max(0, static_cast<int>(std::floor((std::min(x0, x1) - TILE_REACH) / size)));
+    int lastColumn = std::min(grid.columns - 1, static_cast<int>(std::floor((std::max(x0, x1) + TILE_REACH) / size)));
+
+    for (int column = firstColumn; column <= lastColumn; ++column) {
+        // Part of the line inside this column band (widened by the reach)
+        float ya = y0, yb = y1;
+        if (dx != 0.0f) {
+            float ta = (column * size - TILE_REACH - x0) / dx;
+            float tb = ((column + 1) * size + TILE_REACH - x0) / dx;
+            if (ta > tb) std::swap(ta, tb);
+            ta = std::clamp(ta, 0.0f, 1.0f);
+            tb = std::clamp(tb, 0.0f, 1.0f);
+            ya = y0 + ta * dy;
+            yb = y0 + tb * dy;
+        }
+        int firstRow = std::max(0, static_cast<int>(std::floor((std::min(ya, yb) - TILE_REACH) / size)));
+        int lastRow = std::min(grid.rows - 1, static_cast<int>(std::floor((std::max(ya, yb) + TILE_REACH) / size)));
+        for (int row = firstRow; row <= lastRow; ++row)
+            visit(static_cast<size_t>(row) * grid.columns + column);
+    }
+}
+
+void rasterizeLinesTiled(std::span<const Line> lines, RasterMode mode,
+    Framebuffer& target, FrameArena& arena,
+    float r, float g, float b,
+    int tileSize, ThreadPool& pool) {
+    int width = target.viewportWidth(), height = target.viewportHeight();
+    if (lines.empty() || width <= 0 || height <= 0)
+        return;
+    if (tileSize < 1) tileSize = TILE_SIZE;
+
+    TileGrid grid{ tileSize, (width + tileSize - 1) / tileSize, (height + tileSize - 1) / tileSize };
+    size_t tileCount = static_cast<size_t>(grid.columns) * grid.rows;
+
+    // Step 1 : Count the lines crossing every tile
+    std::span<uint32_t> offsets = arena.allocate<uint32_t>(tileCount + 1);
+    std::fill(offsets.begin(), offsets.end(), 0u);
+    for (const Line& line : lines)
+        forEachTile(line, grid, [&](size_t tile) { ++offsets[tile]; });
+
+    // Step 2 : Exclusive prefix sum gives each tile its bin
+    uint32_t total = 0;
+    for (size_t t = 0; t < tileCount; ++t) {
+        uint32_t n = offsets[t];
+        offsets[t] = total;
+        total += n;
+    }
+    offsets[tileCount] = total;
+
+    // Step 3 : Fill the bins, lines stay in input order inside a bin
+    std::span<uint32_t> bins = arena.allocate<uint32_t>(total);
+    std::span<uint32_t> fill = arena.allocate<uint32_t>(tileCount);
+    std::copy(offsets.begin(), offsets.begin() + tileCount, fill.begin());
+    for (size_t i = 0; i < lines.size(); ++i)
+        forEachTile(lines[i], grid, [&](size_t tile) { bins[fill[tile]++] = static_cast<uint32_t>(i); });
+
+    // Step 4 : Draw tile by tile, every line clipped to the tile
+    pool.parallelFor(tileCount, TILE_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t t = begin; t < end; ++t) {
+            int column = static_cast<int>(t % grid.columns), row = static_cast<int>(t / grid.columns);
+            ClipRect rect{ column * tileSize, row * tileSize,
+                std::min(width, (column + 1) * tileSize), std::min(height, (row + 1) * tileSize) };
+
+            for (uint32_t k = offsets[t]; k < offsets[t + 1]; ++k) {
+                const Line& line = lines[bins[k]];
+                if (mode == RasterMode::Bresenham) {
+                    bresenhamLine(roundPixel(line.x0), roundPixel(line.y0), roundPixel(line.x1), roundPixel(line.y1),
+                        target, rect, r, g, b);
+                }
+                else {
+                    xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, target, rect, r, g, b);
+                }
+            }
+        }
+    });
+}
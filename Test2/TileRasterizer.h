@@ -0,0 +1,30 @@
+#pragma once
+
+#include <span>
+
+#include "BatchRasterizer.h"
+#include "FrameArena.h"
+#include "Rasterizer.h"
+#include "ThreadPool.h"
+
+class Framebuffer;
+
+// ---------- Tile binning ----------
+// A long line in a random direction walks the framebuffer with a stride of up
+// to a whole row per pixel, at 4K nearly every pixel is a cache miss.
+// rasterizeLinesTiled first bins the lines into square screen tiles (every
+// tile gets the indices of the lines crossing it, in input order), then draws
+// tile by tile with each line clipped to the tile, so a tile's pixels stay in
+// L1/L2 while it is drawn. Tiles share no pixels and run in parallel without
+// locks; inside a pixel lines still blend in input order, as if they were
+// drawn one by one.
+
+static const int TILE_SIZE = 64; // pixels, 64x64 RGBA8 is 16 KB
+
+// Draw a batch of lines into the target's viewport
+// Bresenham endpoints are rounded to pixels like rasterizeLines does,
+// WuPacked and WuFixed draw the same as Wu. arena only holds the bins.
+void rasterizeLinesTiled(std::span<const Line> lines, RasterMode mode,
+    Framebuffer& target, FrameArena& arena,
+    float r = 1.0f, float g = 0.0f, float b = 1.0f,
+    int tileSize = TILE_SIZE, ThreadPool& pool = defaultThreadPool());
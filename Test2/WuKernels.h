@@ -0,0 +1,434 @@
+#pragma once
+
+#include "Rasterizer.h"
+#include "WuSimd.h"
+#include "Framebuffer.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+
+// Compile-time specialized Xiaolin Wu kernels
+// wuLineKernel<Steep> is the whole algorithm for one orientation, so the
+// steep/non-steep choice is made once per line by wuLineDispatch instead of
+// in every endpoint block and around the main loop.
+//
+// The output is a Sink, chosen at compile time as well:
+//   sink.plot(px, py, alpha)            one covered pixel, screen orientation
+//   sink.template span<Steep>(xStart, xEnd, intery, gradient)
+//                                       optional, replaces the per-pixel main loop
+// and a sink that takes a color is specialized on a color policy:
+//   color.at(px, py) -> WuColor         UniformColor or GradientColor
+// Every combination is a separate instantiation the compiler can inline fully.
+
+struct WuColor {
+    float r, g, b;
+};
+
+// One color for the whole line (folded into the sink, nothing per pixel)
+struct UniformColor {
+    WuColor color;
+
+    WuColor at(float, float) const { return color; }
+};
+
+// Color interpolated from (x0, y0) to (x1, y1), per pixel
+struct GradientColor {
+    WuColor start, end;
+    float x0, y0;
+    float dx, dy, invLengthSq;
+
+    GradientColor(float lx0, float ly0, float lx1, float ly1, WuColor startColor, WuColor endColor)
+        : start(startColor), end(endColor), x0(lx0), y0(ly0), dx(lx1 - lx0), dy(ly1 - ly0) {
+        float lengthSq = dx * dx + dy * dy;
+        invLengthSq = lengthSq > 0.0f ? 1.0f / lengthSq : 0.0f;
+    }
+
+    WuColor at(float px, float py) const {
+        // Project the pixel onto the line, endpoints pixels can land slightly outside
+        float t = ((px - x0) * dx + (py - y0) * dy) * invLengthSq;
+        if (t < 0.0f) t = 0.0f;
+        if (t > 1.0f) t = 1.0f;
+        return { start.r + (end.r - start.r) * t,
+                 start.g + (end.g - start.g) * t,
+                 start.b + (end.b - start.b) * t };
+    }
+};
+
+// ---------- Sinks ----------
+
+// Float vertices (the Vertex format of xiaolinWuLine), NDC or pixels
+template <typename Color>
+struct VertexSink {
+    Vertex* out;
+    OutputMapping map;
+    Color color;
+
+    void plot(float px, float py, float alpha) {
+        WuColor c = color.at(px, py);
+        *out++ = { map.x(px), map.y(py), c.r, c.g, c.b, alpha };
+    }
+
+    // A uniform color runs the main loop on the SIMD kernels from WuSimd
+    template <bool Steep>
+    void span(int xStart, int xEnd, float intery, float gradient)
+        requires std::is_same_v<Color, UniformColor> {
+        out = wuSpanVertices(Steep, xStart, xEnd, intery, gradient,
+            map, color.color.r, color.color.g, color.color.b, out);
+    }
+};
+
+// 6-byte packed vertices, the color is a per-draw table index
+struct PackedVertexSink {
+    PackedVertex* out;
+    uint8_t colorIndex;
+
+    void plot(float px, float py, float alpha) {
+        *out++ = packVertex(px, py, alpha, colorIndex);
+    }
+};
+
+// Alpha blended straight into a CPU framebuffer
+template <typename Color>
+struct FramebufferSink {
+    Framebuffer& target;
+    Color color;
+
+    void plot(float px, float py, float alpha) {
+        // Pixel coordinates are whole numbers, the conversion is exact
+        WuColor c = color.at(px, py);
+        target.blend(static_cast<int>(px), static_cast<int>(py), c.r, c.g, c.b, alpha);
+    }
+};
+
+// Forwards only the pixels inside rect to another sink
+template <typename Sink>
+struct RectSink {
+    Sink& inner;
+    ClipRect rect;
+
+    void plot(float px, float py, float alpha) {
+        if (px < rect.x0 || py < rect.y0 || px >= rect.x1 || py >= rect.y1)
+            return;
+        inner.plot(px, py, alpha);
+    }
+};
+
+// ---------- Kernel ----------
+
+// Per-pixel main loop, used when the sink has no span of its own
+template <bool Steep, typename Sink>
+inline void wuSpanKernel(int xStart, int xEnd, float intery, float gradient, Sink& sink) {
+    for (int x = xStart; x < xEnd; ++x) {
+        float y = intery;
+        float ypxl = std::floor(y);
+        float f = y - ypxl;
+        if constexpr (Steep) {
+            sink.plot(ypxl, float(x), 1.0f - f); // we swap x and y here (we are in steep mode)
+            sink.plot(ypxl + 1, float(x), f);
+        }
+        else {
+            sink.plot(float(x), ypxl, 1.0f - f);
+            sink.plot(float(x), ypxl + 1, f);
+        }
+
+        intery += gradient;
+    }
+}
+
+// One endpoint column: the pixel at ypxl and the one above it
+template <bool Steep, typename Sink>
+inline void wuEndpointKernel(float xpxl, float yend, float xgap, Sink& sink) {
+    float ypxl = std::floor(yend);
+    float f = yend - ypxl;
+    if constexpr (Steep) {
+        sink.plot(ypxl, xpxl, (1.0f - f) * xgap);
+        sink.plot(ypxl + 1, xpxl, f * xgap);
+    }
+    else {
+        sink.plot(xpxl, ypxl, (1.0f - f) * xgap);
+        sink.plot(xpxl, ypxl + 1, f * xgap);
+    }
+}
+
+// The Wu algorithm for one orientation
+// Steep lines run with x and y swapped, the sink always receives screen coordinates.
+template <bool Steep, typename Sink>
+inline void wuLineKernel(float x0, float y0, float x1, float y1, Sink& sink) {
+
+	// Step 1 : Handle steep lines
+	// The dispatcher already knows whether the line is steep,
+	// here we only swap into major/minor order and draw left to right
+
+    float X0 = Steep ? y0 : x0, Y0 = Steep ? x0 : y0;
+    float X1 = Steep ? y1 : x1, Y1 = Steep ? x1 : y1;
+    if (X0 > X1) {
+        std::swap(X0, X1);
+        std::swap(Y0, Y1);
+    }
+
+	// Step 2 : Compute the line parameters
+	// This means calculating the slope (gradient)
+
+    float dx = X1 - X0;
+    float dy = Y1 - Y0;
+    float gradient = (dx == 0.0f) ? 1.0f : (dy / dx);
+
+	// Step 3 : Handle the endpoints
+	// We need to handle the first and last pixels separately
+
+    float xpxl1 = std::floor(X0);
+    float yend1 = Y0 + gradient * (xpxl1 - X0);
+    wuEndpointKernel<Steep>(xpxl1, yend1, 1.0f - (X0 - xpxl1), sink);
+
+    float intery = yend1 + gradient; // first y-intersection for the main loop, after the first endpoint
+
+    float xpxl2 = std::ceil(X1);
+    float yend2 = Y1 + gradient * (xpxl2 - X1);
+    wuEndpointKernel<Steep>(xpxl2, yend2, 1.0f - (X1 - xpxl2), sink);
+
+	// Step 4 : Draw the line
+	// We must now draw the pixels between the two endpoints
+
+    int xStart = int(xpxl1) + 1, xEnd = int(xpxl2);
+    if constexpr (requires { sink.template span<Steep>(xStart, xEnd, intery, gradient); })
+        sink.template span<Steep>(xStart, xEnd, intery, gradient);
+    else
+        wuSpanKernel<Steep>(xStart, xEnd, intery, gradient, sink);
+}
+
+// Picks the instantiation for a line
+// A line is steep if the absolute slope is greater than 1
+template <typename Sink>
+inline void wuLineDispatch(float x0, float y0, float x1, float y1, Sink& sink) {
+    if (std::abs(y1 - y0) > std::abs(x1 - x0))
+        wuLineKernel<true>(x0, y0, x1, y1, sink);
+    else
+        wuLineKernel<false>(x0, y0, x1, y1, sink);
+}
+
+// ---------- Polyline segments ----------
+// Consecutive segments of a polyline share an endpoint. Wu's endpoint
+// columns weight one column by xgap, which is above 1 at the far end, so
+// two segments both drawing the joint make it too bright. At a joint end a
+// segment has no endpoint column: along the major axis it covers the columns
+// up to and including the joint (its far end) or the ones past it (its near
+// end), all with main-loop coverage. Two segments with the same major axis
+// and direction then cover every column exactly once, the same pixels an
+// unsplit line would.
+
+template <bool Steep, typename Sink>
+inline void wuSegmentKernel(float x0, float y0, float x1, float y1, bool joinStart, bool joinEnd, Sink& sink) {
+    float X0 = Steep ? y0 : x0, Y0 = Steep ? x0 : y0;
+    float X1 = Steep ? y1 : x1, Y1 = Steep ? x1 : y1;
+    if (X0 > X1) {
+        std::swap(X0, X1);
+        std::swap(Y0, Y1);
+        std::swap(joinStart, joinEnd);
+    }
+
+    float dx = X1 - X0;
+    float dy = Y1 - Y0;
+    float gradient = (dx == 0.0f) ? 1.0f : (dy / dx);
+
+    float xpxl1 = std::floor(X0);
+    float yend1 = Y0 + gradient * (xpxl1 - X0);
+    if (!joinStart)
+        wuEndpointKernel<Steep>(xpxl1, yend1, 1.0f - (X0 - xpxl1), sink);
+
+    float intery = yend1 + gradient;
+
+    // The main loop ends before ceil(X1), a joint takes it through floor(X1)
+    float xpxl2 = std::ceil(X1);
+    int xEnd = int(xpxl2);
+    if (joinEnd)
+        xEnd = int(std::floor(X1)) + 1;
+    else
+        wuEndpointKernel<Steep>(xpxl2, Y1 + gradient * (xpxl2 - X1), 1.0f - (X1 - xpxl2), sink);
+
+    int xStart = int(xpxl1) + 1;
+    if constexpr (requires { sink.template span<Steep>(xStart, xEnd, intery, gradient); })
+        sink.template span<Steep>(xStart, xEnd, intery, gradient);
+    else
+        wuSpanKernel<Steep>(xStart, xEnd, intery, gradient, sink);
+}
+
+// joinStart / joinEnd: (x0, y0) / (x1, y1) is shared with another segment
+template <typename Sink>
+inline void wuSegmentDispatch(float x0, float y0, float x1, float y1, bool joinStart, bool joinEnd, Sink& sink) {
+    if (std::abs(y1 - y0) > std::abs(x1 - x0))
+        wuSegmentKernel<true>(x0, y0, x1, y1, joinStart, joinEnd, sink);
+    else
+        wuSegmentKernel<false>(x0, y0, x1, y1, joinStart, joinEnd, sink);
+}
+
+// ---------- Fixed-point kernel ----------
+// The same algorithm on 16.16 integers: floor is a mask, fpart is the low
+// 16 bits and the 8-bit coverage is the top 8 of them. The only divide is the
+// gradient, once per line. The sink takes whole pixels and 8-bit coverage:
+//   sink.plot(px, py, coverage)
+
+// 16.16 multiply, the product needs 64 bits
+inline Fixed fixedMul(Fixed a, Fixed b) {
+    return static_cast<Fixed>((static_cast<int64_t>(a) * b) >> FIXED_SHIFT);
+}
+
+// 16.16 coverage in [0, 2) to 8 bits, the second endpoint's xgap can exceed 1
+inline int fixedCoverage(Fixed c) {
+    int v = c >> (FIXED_SHIFT - 8);
+    return v > 255 ? 255 : v;
+}
+
+// 6-byte packed vertices straight from integer pixels
+struct FixedPackedSink {
+    PackedVertex* out;
+    uint8_t colorIndex;
+
+    void plot(int px, int py, int coverage) {
+        *out++ = { static_cast<int16_t>(px), static_cast<int16_t>(py), static_cast<uint8_t>(coverage), colorIndex };
+    }
+
+    void plotAt(int index, int px, int py, int coverage) {
+        out[index] = { static_cast<int16_t>(px), static_cast<int16_t>(py), static_cast<uint8_t>(coverage), colorIndex };
+    }
+
+    void advance(int count) { out += count; }
+};
+
+template <bool Steep, typename Sink>
+inline void wuFixedEndpointKernel(int xpxl, Fixed yend, Fixed xgap, Sink& sink) {
+    int ypxl = yend >> FIXED_SHIFT;
+    Fixed f = yend & (FIXED_ONE - 1);
+    int c0 = fixedCoverage(fixedMul(FIXED_ONE - f, xgap));
+    int c1 = fixedCoverage(fixedMul(f, xgap));
+    if constexpr (Steep) {
+        sink.plot(ypxl, xpxl, c0);
+        sink.plot(ypxl + 1, xpxl, c1);
+    }
+    else {
+        sink.plot(xpxl, ypxl, c0);
+        sink.plot(xpxl, ypxl + 1, c1);
+    }
+}
+
+// Steps 1 to 3, shared by both main loops: draws the endpoint columns and
+// returns the main loop's columns [xStart, xEnd), intery at xStart and the gradient
+template <bool Steep, typename Sink>
+inline void wuFixedLineSetup(Fixed x0, Fixed y0, Fixed x1, Fixed y1, Sink& sink,
+    int& xStart, int& xEnd, Fixed& intery, Fixed& gradient) {
+
+	// Step 1 : Handle steep lines
+
+    Fixed X0 = Steep ? y0 : x0, Y0 = Steep ? x0 : y0;
+    Fixed X1 = Steep ? y1 : x1, Y1 = Steep ? x1 : y1;
+    if (X0 > X1) {
+        std::swap(X0, X1);
+        std::swap(Y0, Y1);
+    }
+
+	// Step 2 : Compute the gradient, the only divide
+
+    int64_t dx = static_cast<int64_t>(X1) - X0;
+    int64_t dy = static_cast<int64_t>(Y1) - Y0;
+    // Rounded to nearest, a truncated gradient drifts in one direction along the line
+    int64_t half = (dy < 0 ? -dx : dx) / 2;
+    gradient = (dx == 0) ? FIXED_ONE : static_cast<Fixed>(((dy << FIXED_SHIFT) + half) / dx);
+
+	// Step 3 : Handle the endpoints
+
+    Fixed xpxl1 = X0 & ~(FIXED_ONE - 1);
+    Fixed yend1 = Y0 + fixedMul(gradient, xpxl1 - X0);
+    wuFixedEndpointKernel<Steep>(xpxl1 >> FIXED_SHIFT, yend1, FIXED_ONE - (X0 - xpxl1), sink);
+
+    intery = yend1 + gradient;
+
+    Fixed xpxl2 = (X1 + FIXED_ONE - 1) & ~(FIXED_ONE - 1);
+    Fixed yend2 = Y1 + fixedMul(gradient, xpxl2 - X1);
+    wuFixedEndpointKernel<Steep>(xpxl2 >> FIXED_SHIFT, yend2, FIXED_ONE - (X1 - xpxl2), sink);
+
+    xStart = (xpxl1 >> FIXED_SHIFT) + 1;
+    xEnd = xpxl2 >> FIXED_SHIFT;
+}
+
+// One main loop column
+// Coverage of the pixel above is the top 8 fractional bits, the two add up to 255
+template <bool Steep, typename Plot>
+inline void wuFixedColumn(int x, Fixed intery, Plot&& plot) {
+    int ypxl = intery >> FIXED_SHIFT;
+    int f = (intery >> (FIXED_SHIFT - 8)) & 0xFF;
+    if constexpr (Steep) {
+        plot(ypxl, x, 255 - f);
+        plot(ypxl + 1, x, f);
+    }
+    else {
+        plot(x, ypxl, 255 - f);
+        plot(x, ypxl + 1, f);
+    }
+}
+
+template <bool Steep, typename Sink>
+inline void wuFixedLineKernel(Fixed x0, Fixed y0, Fixed x1, Fixed y1, Sink& sink) {
+    int xStart, xEnd;
+    Fixed intery, gradient;
+    wuFixedLineSetup<Steep>(x0, y0, x1, y1, sink, xStart, xEnd, intery, gradient);
+
+	// Step 4 : Draw the line
+
+    auto plot = [&](int px, int py, int coverage) { sink.plot(px, py, coverage); };
+    for (int x = xStart; x < xEnd; ++x) {
+        wuFixedColumn<Steep>(x, intery, plot);
+        intery += gradient;
+    }
+}
+
+// Two-ended main loop: every iteration draws one column from each end
+// toward the middle. In integers intery at column k is exactly
+// intery + k * gradient, so the far end starts there and steps back with
+// the same values the forward loop reaches, and the two chains are
+// independent. The sink writes by position instead of appending:
+//   sink.plotAt(index, px, py, coverage)  vertex index from the current end
+//   sink.advance(count)                   then moves the end past them
+template <bool Steep, typename Sink>
+inline void wuFixedLineKernelTwoEnded(Fixed x0, Fixed y0, Fixed x1, Fixed y1, Sink& sink) {
+    int xStart, xEnd;
+    Fixed intery, gradient;
+    wuFixedLineSetup<Steep>(x0, y0, x1, y1, sink, xStart, xEnd, intery, gradient);
+    if (xEnd <= xStart)
+        return;
+
+	// Step 4 : Draw the line from both ends
+
+    int lo = 0, hi = xEnd - xStart - 1;
+    Fixed front = intery;
+    Fixed back = static_cast<Fixed>(intery + static_cast<int64_t>(hi) * gradient);
+    for (; lo < hi; ++lo, --hi) {
+        int a = 2 * lo, b = 2 * hi;
+        wuFixedColumn<Steep>(xStart + lo, front, [&](int px, int py, int c) { sink.plotAt(a++, px, py, c); });
+        wuFixedColumn<Steep>(xStart + hi, back, [&](int px, int py, int c) { sink.plotAt(b++, px, py, c); });
+        front += gradient;
+        back -= gradient;
+    }
+    if (lo == hi) {
+        int a = 2 * lo;
+        wuFixedColumn<Steep>(xStart + lo, front, [&](int px, int py, int c) { sink.plotAt(a++, px, py, c); });
+    }
+    sink.advance(2 * (xEnd - xStart));
+}
+
+template <typename Sink>
+inline void wuFixedLineDispatch(Fixed x0, Fixed y0, Fixed x1, Fixed y1, Sink& sink) {
+    if (std::abs(static_cast<int64_t>(y1) - y0) > std::abs(static_cast<int64_t>(x1) - x0))
+        wuFixedLineKernel<true>(x0, y0, x1, y1, sink);
+    else
+        wuFixedLineKernel<false>(x0, y0, x1, y1, sink);
+}
+
+template <typename Sink>
+inline void wuFixedLineDispatchTwoEnded(Fixed x0, Fixed y0, Fixed x1, Fixed y1, Sink& sink) {
+    if (std::abs(static_cast<int64_t>(y1) - y0) > std::abs(static_cast<int64_t>(x1) - x0))
+        wuFixedLineKernelTwoEnded<true>(x0, y0, x1, y1, sink);
+    else
+        wuFixedLineKernelTwoEnded<false>(x0, y0, x1, y1, sink);
+}
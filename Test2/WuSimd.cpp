@@ -0,0 +1,294 @@
+#include "WuSimd.h"
+
+#include <atomic>
+#include <cmath>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define WU_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define WU_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+// GCC and Clang only emit SSE4.1/AVX instructions in functions that ask for them,
+// MSVC accepts the intrinsics anywhere
+#if defined(WU_SIMD_X86) && (defined(__GNUC__) || defined(__clang__))
+#define WU_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define WU_TARGET_AVX __attribute__((target("avx")))
+#else
+#define WU_TARGET_SSE41
+#define WU_TARGET_AVX
+#endif
+
+// ---------- Scalar ----------
+// Same arithmetic as the original loop in xiaolinWuLine
+
+static Vertex* wuSpanScalar(bool steep, int xStart, int xEnd, float intery, float gradient,
+    int width, int height, float r, float g, float b, Vertex* out) {
+    float majorSize = float(steep ? height : width);
+    float minorSize = float(steep ? width : height);
+
+    for (int x = xStart; x < xEnd; ++x) {
+        float y = intery;
+        float yFloor = std::floor(y);
+        float f = y - yFloor;
+        float major = (2.0f * (float(x) + 0.5f)) / majorSize - 1.0f;
+        float minor1 = (2.0f * (yFloor + 0.5f)) / minorSize - 1.0f;
+        float minor2 = (2.0f * (yFloor + 1 + 0.5f)) / minorSize - 1.0f;
+
+        if (steep) {
+            *out++ = { minor1, major, r, g, b, 1.0f - f };
+            *out++ = { minor2, major, r, g, b, f };
+        }
+        else {
+            *out++ = { major, minor1, r, g, b, 1.0f - f };
+            *out++ = { major, minor2, r, g, b, f };
+        }
+
+        intery += gradient;
+    }
+    return out;
+}
+
+// Pixel space: the coordinates are the pixels themselves, no divides left to
+// vectorize, only the serial intery and one floor per column
+static Vertex* wuSpanPixels(bool steep, int xStart, int xEnd, float intery, float gradient,
+    float r, float g, float b, Vertex* out) {
+    for (int x = xStart; x < xEnd; ++x) {
+        float yFloor = std::floor(intery);
+        float f = intery - yFloor;
+        if (steep) {
+            *out++ = { yFloor, float(x), r, g, b, 1.0f - f };
+            *out++ = { yFloor + 1, float(x), r, g, b, f };
+        }
+        else {
+            *out++ = { float(x), yFloor, r, g, b, 1.0f - f };
+            *out++ = { float(x), yFloor + 1, r, g, b, f };
+        }
+
+        intery += gradient;
+    }
+    return out;
+}
+
+// Interleave one block of columns back into AoS vertices
+template <int W>
+static Vertex* storeColumns(bool steep, const float* major, const float* minor1, const float* minor2,
+    const float* f, float r, float g, float b, Vertex* out) {
+    for (int k = 0; k < W; ++k) {
+        if (steep) {
+            out[0] = { minor1[k], major[k], r, g, b, 1.0f - f[k] };
+            out[1] = { minor2[k], major[k], r, g, b, f[k] };
+        }
+        else {
+            out[0] = { major[k], minor1[k], r, g, b, 1.0f - f[k] };
+            out[1] = { major[k], minor2[k], r, g, b, f[k] };
+        }
+        out += 2;
+    }
+    return out;
+}
+
+#if defined(WU_SIMD_X86)
+
+// ---------- SSE4.1 ----------
+
+WU_TARGET_SSE41
+static Vertex* wuSpanSSE41(bool steep, int xStart, int xEnd, float intery, float gradient,
+    int width, int height, float r, float g, float b, Vertex* out) {
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 majorSize = _mm_set1_ps(float(steep ? height : width));
+    const __m128 minorSize = _mm_set1_ps(float(steep ? width : height));
+    const __m128 lane = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+    alignas(16) float ys[4], major[4], minor1[4], minor2[4], f[4];
+
+    int x = xStart;
+    for (; x + 4 <= xEnd; x += 4) {
+        // Serial accumulation keeps intery identical to the scalar loop
+        for (int k = 0; k < 4; ++k) { ys[k] = intery; intery += gradient; }
+
+        __m128 vy = _mm_load_ps(ys);
+        __m128 vFloor = _mm_floor_ps(vy);
+        __m128 vx = _mm_add_ps(_mm_set1_ps(float(x)), lane);
+
+        _mm_store_ps(f, _mm_sub_ps(vy, vFloor));
+        _mm_store_ps(major, _mm_sub_ps(_mm_div_ps(_mm_mul_ps(two, _mm_add_ps(vx, half)), majorSize), one));
+        _mm_store_ps(minor1, _mm_sub_ps(_mm_div_ps(_mm_mul_ps(two, _mm_add_ps(vFloor, half)), minorSize), one));
+        _mm_store_ps(minor2, _mm_sub_ps(_mm_div_ps(_mm_mul_ps(two, _mm_add_ps(_mm_add_ps(vFloor, one), half)), minorSize), one));
+
+        out = storeColumns<4>(steep, major, minor1, minor2, f, r, g, b, out);
+    }
+    return wuSpanScalar(steep, x, xEnd, intery, gradient, width, height, r, g, b, out);
+}
+
+// ---------- AVX ----------
+
+WU_TARGET_AVX
+static Vertex* wuSpanAVX(bool steep, int xStart, int xEnd, float intery, float gradient,
+    int width, int height, float r, float g, float b, Vertex* out) {
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 majorSize = _mm256_set1_ps(float(steep ? height : width));
+    const __m256 minorSize = _mm256_set1_ps(float(steep ? width : height));
+    const __m256 lane = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+
+    alignas(32) float ys[8], major[8], minor1[8], minor2[8], f[8];
+
+    int x = xStart;
+    for (; x + 8 <= xEnd; x += 8) {
+        for (int k = 0; k < 8; ++k) { ys[k] = intery; intery += gradient; }
+
+        __m256 vy = _mm256_load_ps(ys);
+        __m256 vFloor = _mm256_floor_ps(vy);
+        __m256 vx = _mm256_add_ps(_mm256_set1_ps(float(x)), lane);
+
+        _mm256_store_ps(f, _mm256_sub_ps(vy, vFloor));
+        _mm256_store_ps(major, _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(two, _mm256_add_ps(vx, half)), majorSize), one));
+        _mm256_store_ps(minor1, _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(two, _mm256_add_ps(vFloor, half)), minorSize), one));
+        _mm256_store_ps(minor2, _mm256_sub_ps(_mm256_div_ps(_mm256_mul_ps(two, _mm256_add_ps(_mm256_add_ps(vFloor, one), half)), minorSize), one));
+
+        out = storeColumns<8>(steep, major, minor1, minor2, f, r, g, b, out);
+    }
+    return wuSpanScalar(steep, x, xEnd, intery, gradient, width, height, r, g, b, out);
+}
+
+#endif
+
+#if defined(WU_SIMD_NEON)
+
+// ---------- NEON ----------
+
+static Vertex* wuSpanNEON(bool steep, int xStart, int xEnd, float intery, float gradient,
+    int width, int height, float r, float g, float b, Vertex* out) {
+    const float32x4_t half = vdupq_n_f32(0.5f);
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    const float32x4_t two = vdupq_n_f32(2.0f);
+    const float32x4_t majorSize = vdupq_n_f32(float(steep ? height : width));
+    const float32x4_t minorSize = vdupq_n_f32(float(steep ? width : height));
+    const float laneInit[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float32x4_t lane = vld1q_f32(laneInit);
+
+    float ys[4], major[4], minor1[4], minor2[4], f[4];
+
+    int x = xStart;
+    for (; x + 4 <= xEnd; x += 4) {
+        for (int k = 0; k < 4; ++k) { ys[k] = intery; intery += gradient; }
+
+        // vmulq/vaddq separately, a fused multiply-add would change the rounding
+        float32x4_t vy = vld1q_f32(ys);
+        float32x4_t vFloor = vrndmq_f32(vy);
+        float32x4_t vx = vaddq_f32(vdupq_n_f32(float(x)), lane);
+
+        vst1q_f32(f, vsubq_f32(vy, vFloor));
+        vst1q_f32(major, vsubq_f32(vdivq_f32(vmulq_f32(two, vaddq_f32(vx, half)), majorSize), one));
+        vst1q_f32(minor1, vsubq_f32(vdivq_f32(vmulq_f32(two, vaddq_f32(vFloor, half)), minorSize), one));
+        vst1q_f32(minor2, vsubq_f32(vdivq_f32(vmulq_f32(two, vaddq_f32(vaddq_f32(vFloor, one), half)), minorSize), one));
+
+        out = storeColumns<4>(steep, major, minor1, minor2, f, r, g, b, out);
+    }
+    return wuSpanScalar(steep, x, xEnd, intery, gradient, width, height, r, g, b, out);
+}
+
+#endif
+
+// ---------- Dispatch ----------
+
+bool cpuSupports(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::Scalar:
+        return true;
+#if defined(WU_SIMD_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+    case SimdLevel::SSE41: {
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 19)) != 0;
+    }
+    case SimdLevel::AVX: {
+        // AVX also needs the OS to save the YMM registers (OSXSAVE + XCR0)
+        int info[4];
+        __cpuid(info, 1);
+        bool avx = (info[2] & (1 << 28)) != 0;
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        return avx && osxsave && (_xgetbv(0) & 0x6) == 0x6;
+    }
+#else
+    case SimdLevel::SSE41:
+        return __builtin_cpu_supports("sse4.1");
+    case SimdLevel::AVX:
+        return __builtin_cpu_supports("avx");
+#endif
+#endif
+#if defined(WU_SIMD_NEON)
+    case SimdLevel::NEON:
+        return true;
+#endif
+    default:
+        return false;
+    }
+}
+
+SimdLevel detectSimdLevel() {
+    static const SimdLevel detected = [] {
+        if (cpuSupports(SimdLevel::AVX)) return SimdLevel::AVX;
+        if (cpuSupports(SimdLevel::SSE41)) return SimdLevel::SSE41;
+        if (cpuSupports(SimdLevel::NEON)) return SimdLevel::NEON;
+        return SimdLevel::Scalar;
+    }();
+    return detected;
+}
+
+// Read by worker threads (batch rasterizer, frame pipeline) while a benchmark
+// may set it. A function local, so it is detected on first use instead of
+// depending on the order of static initialization.
+static std::atomic<SimdLevel>& activeLevel() {
+    static std::atomic<SimdLevel> level{ detectSimdLevel() };
+    return level;
+}
+
+SimdLevel getSimdLevel() {
+    return activeLevel().load(std::memory_order_relaxed);
+}
+
+void setSimdLevel(SimdLevel level) {
+    activeLevel().store(cpuSupports(level) ? level : SimdLevel::Scalar, std::memory_order_relaxed);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+    case SimdLevel::SSE41: return "SSE4.1";
+    case SimdLevel::AVX: return "AVX";
+    case SimdLevel::NEON: return "NEON";
+    default: return "Scalar";
+    }
+}
+
+Vertex* wuSpanVertices(bool steep, int xStart, int xEnd, float intery, float gradient,
+    const OutputMapping& map, float r, float g, float b, Vertex* out) {
+    if (map.pixels)
+        return wuSpanPixels(steep, xStart, xEnd, intery, gradient, r, g, b, out);
+
+    int width = int(map.width), height = int(map.height);
+    switch (getSimdLevel()) {
+#if defined(WU_SIMD_X86)
+    case SimdLevel::AVX:
+        return wuSpanAVX(steep, xStart, xEnd, intery, gradient, width, height, r, g, b, out);
+    case SimdLevel::SSE41:
+        return wuSpanSSE41(steep, xStart, xEnd, intery, gradient, width, height, r, g, b, out);
+#endif
+#if defined(WU_SIMD_NEON)
+    case SimdLevel::NEON:
+        return wuSpanNEON(steep, xStart, xEnd, intery, gradient, width, height, r, g, b, out);
+#endif
+    default:
+        return wuSpanScalar(steep, xStart, xEnd, intery, gradient, width, height, r, g, b, out);
+    }
+}
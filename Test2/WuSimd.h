@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Rasterizer.h"
+
+// SIMD kernels for the main loop of xiaolinWuLine (float Vertex output)
+// Each kernel produces the same vertices as the scalar loop, bit for bit:
+// intery is still accumulated serially (one add per column), everything that
+// follows from it (floor, coverage and both NDC divides) runs on whole vectors.
+
+enum class SimdLevel {
+    Scalar,
+    SSE41,  // 4 columns per iteration
+    AVX,    // 8 columns per iteration
+    NEON,   // 4 columns per iteration
+};
+
+// Whether this CPU (and build) can run the level, Scalar always can
+bool cpuSupports(SimdLevel level);
+
+// Best level supported by this CPU (checked once)
+SimdLevel detectSimdLevel();
+
+// Level used by xiaolinWuLine, defaults to detectSimdLevel()
+// Setting a level the CPU doesn't support falls back to Scalar.
+SimdLevel getSimdLevel();
+void setSimdLevel(SimdLevel level);
+
+const char* simdLevelName(SimdLevel level);
+
+// Emits two vertices per major-axis column x in [xStart, xEnd)
+// intery is the minor coordinate at xStart, advanced by gradient per column
+// The SIMD levels cover the NDC conversion, pixel space has nothing to convert
+Vertex* wuSpanVertices(bool steep, int xStart, int xEnd, float intery, float gradient,
+    const OutputMapping& map, float r, float g, float b, Vertex* out);
@@ -0,0 +1,41 @@
+# Embeds every .glsl file next to this script into ShaderSources.h as a raw
+# string literal, so the program has its shaders wherever it is started from.
+# Run by the pre-build event of Test2. The header is only rewritten when a
+# shader changed, so an unchanged tree doesn't recompile anything.
+
+$ErrorActionPreference = "Stop"
+
+$dir = $PSScriptRoot
+$out = Join-Path $dir "ShaderSources.h"
+
+# Ordinal order, the same on every machine
+$names = [System.IO.Directory]::GetFiles($dir, "*.glsl") | ForEach-Object { [System.IO.Path]::GetFileName($_) }
+$names = [string[]]$names
+[Array]::Sort($names, [StringComparer]::Ordinal)
+
+$text = New-Object System.Text.StringBuilder
+[void]$text.Append("// Generated by embed_shaders.ps1 from the .glsl files in this directory, do not edit`n")
+[void]$text.Append("// The .glsl files are the sources, the pre-build event regenerates this header.`n")
+[void]$text.Append("#pragma once`n`n")
+[void]$text.Append("struct EmbeddedShader {`n")
+[void]$text.Append("    const char* name;   // file name of the source`n")
+[void]$text.Append("    const char* source;`n")
+[void]$text.Append("};`n`n")
+[void]$text.Append("constexpr EmbeddedShader EMBEDDED_SHADERS[] = {`n")
+
+foreach ($name in $names) {
+    $source = [System.IO.File]::ReadAllText((Join-Path $dir $name)) -replace "`r`n", "`n"
+    if ($source.Contains(')glsl"')) {
+        Write-Error "$name contains the raw string delimiter )glsl`""
+        exit 1
+    }
+    [void]$text.Append("    { `"$name`", R`"glsl($source)glsl`" },`n")
+}
+
+[void]$text.Append("};`n")
+
+$header = $text.ToString()
+if (!(Test-Path $out) -or [System.IO.File]::ReadAllText($out) -ne $header) {
+    [System.IO.File]::WriteAllText($out, $header, (New-Object System.Text.UTF8Encoding $false))
+    Write-Host "ShaderSources.h updated"
+}
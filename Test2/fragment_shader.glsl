@@ -1,9 +1,11 @@
 #version 330 core
 
 in vec4 vColor;
-out vec4 FragColor;
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Weight; // coverage weight, only CoverageBuffer keeps it
 
 void main()
 {
     FragColor = vColor;
+    Weight = vec4(1.0, 0.0, 0.0, vColor.a);
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#version 330 core
+// Wu coverage of the quad path, evaluated per target pixel
+// In the main loop Wu gives the pixel at minor offset n of column m the
+// coverage 1 - |y(m) - n| (clamped at 0): the floor pixel gets 1 - fpart(y),
+// the one above fpart(y), everything else nothing. The endpoint columns use
+// yend and are scaled by xgap, as in xiaolinWuLine.
+// That is the overlap of the pixel with a band one pixel thick around the
+// line, so thicker lines (vWidth, see scene_vertex_shader.glsl) widen the band.
+//
+// A fragment can cover several target pixels (the demo draws the target into
+// half-size cells), so every target pixel whose center is inside the fragment
+// contributes, combined the way their points would have been blended.
+
+flat in vec4 vLine;
+flat in int vSteep;
+flat in vec4 vColor;
+flat in float vWidth;
+in vec2 vPixel;
+
+uniform int combine; // 0 = alpha blended, 1 = max, 2 = additive (see CoverageBuffer)
+
+layout (location = 0) out vec4 FragColor;
+layout (location = 1) out vec4 Weight; // coverage weight, only CoverageBuffer keeps it
+
+float wuCoverage(vec2 pixel) {
+    float x0 = vLine.x, y0 = vLine.y, x1 = vLine.z, y1 = vLine.w;
+    float major = vSteep == 1 ? pixel.y : pixel.x;
+    float minor = vSteep == 1 ? pixel.x : pixel.y;
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    if (major < xpxl1 || major > xpxl2)
+        return 0.0;
+
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+    float y, xgap = 1.0;
+    if (major == xpxl1) {
+        y = yend1;
+        xgap = 1.0 - (x0 - xpxl1);
+    }
+    else if (major == xpxl2) {
+        y = y1 + gradient * (xpxl2 - x1);
+        xgap = 1.0 - (x1 - xpxl2);
+    }
+    else {
+        y = yend1 + gradient * (major - xpxl1);
+    }
+    // Overlap of [y - w/2, y + w/2] with the pixel [minor - 0.5, minor + 0.5],
+    // 1 - |y - minor| for w = 1
+    float halfWidth = 0.5 * vWidth;
+    float overlap = min(y + halfWidth, minor + 0.5) - max(y - halfWidth, minor - 0.5);
+    return clamp(overlap * xgap, 0.0, 1.0);
+}
+
+void main() {
+    // Target pixels with their center inside this fragment, at most 4 per axis
+    vec2 footprint = max(fwidth(vPixel), vec2(1.0));
+    vec2 first = ceil(vPixel - 0.5 * footprint);
+    vec2 last = ceil(vPixel + 0.5 * footprint) - 1.0;
+
+    float transmit = 1.0, maxCoverage = 0.0, sum = 0.0;
+    for (int j = 0; j < 4; ++j) {
+        float py = first.y + float(j);
+        if (py > last.y) break;
+        for (int i = 0; i < 4; ++i) {
+            float px = first.x + float(i);
+            if (px > last.x) break;
+            float c = wuCoverage(vec2(px, py));
+            transmit *= 1.0 - c;
+            maxCoverage = max(maxCoverage, c);
+            sum += c;
+        }
+    }
+
+    float coverage = (combine == 1 ? maxCoverage : combine == 2 ? sum : 1.0 - transmit) * vColor.a;
+    if (coverage <= 0.0)
+        discard;
+    FragColor = vec4(vColor.rgb, coverage);
+    Weight = vec4(1.0, 0.0, 0.0, coverage);
+}
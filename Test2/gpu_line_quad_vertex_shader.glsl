@@ -0,0 +1,67 @@
+#version 330 core
+// GPU Wu lines as one quad per segment instead of one point per pixel.
+// The 4 vertices of an instance (a triangle strip) are the corners of the
+// band around the line that holds every pixel Wu plots: the columns from
+// floor(x0) to ceil(x1) and 2 pixels either side of the line, sheared along
+// it. gpu_line_quad_fragment_shader.glsl works out each pixel's coverage.
+// Instances come in pairs (divisor 2), one per cell, like gpu_line_vertex_shader.glsl.
+layout (location = 0) in vec4 aLine; // x0, y0, x1, y1 (pixels)
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+uniform vec3 lineColor;
+
+flat out vec4 vLine;  // major/minor endpoints after the steep swap, x0 <= x1
+flat out int vSteep;
+flat out vec4 vColor; // rgb, opacity
+flat out float vWidth; // minor-axis thickness, 1 = Wu's line
+out vec2 vPixel;      // target pixel coordinates, pixel p is centered on p
+
+void main() {
+    float x0 = aLine.x, y0 = aLine.y, x1 = aLine.z, y1 = aLine.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = aLine.y; y0 = aLine.x; x1 = aLine.w; y1 = aLine.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+
+    // Half a pixel past the endpoint columns, 2 pixels above and below the line:
+    // Wu's two pixels reach 1.5 from it and a sample can sit half a pixel off center
+    int corner = gl_VertexID;
+    float major = corner < 2 ? xpxl1 - 0.5 : xpxl2 + 0.5;
+    float minor = yend1 + gradient * (major - xpxl1) + (corner % 2 == 0 ? -2.0 : 2.0);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    vPixel = pixel;
+    vLine = vec4(x0, y0, x1, y1);
+    vSteep = steep ? 1 : 0;
+    vColor = vec4(lineColor, 1.0);
+    vWidth = 1.0;
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID % 2;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+}
@@ -0,0 +1,133 @@
+#version 330 core
+// GPU line backend: only the line endpoints are uploaded, every vertex of
+// a draw rasterizes one pixel of its line from gl_VertexID.
+// Instances come in pairs (divisor 2), one per cell of the algorithm.
+layout (location = 0) in vec4 aLine; // x0, y0, x1, y1 (pixels)
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform int lineMode;    // 0 = Bresenham, 1 = Xiaolin Wu
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+uniform vec3 lineColor;  // Wu color
+
+out vec4 vColor;
+
+// Matches std::round on the CPU (half away from zero), GLSL round() doesn't specify ties
+float roundHalfAway(float v) {
+    return sign(v) * floor(abs(v) + 0.5);
+}
+
+float fpart(float x) { return x - floor(x); }
+float rfpart(float x) { return 1.0 - fpart(x); }
+
+// Vertices past the end of a shorter line are clipped away
+void cull() {
+    gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+    gl_ClipDistance[0] = -1.0;
+    gl_ClipDistance[1] = -1.0;
+    gl_ClipDistance[2] = -1.0;
+    gl_ClipDistance[3] = -1.0;
+    vColor = vec4(0.0);
+}
+
+void emit(vec2 pixel, vec4 color) {
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID % 2;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : color;
+}
+
+// Pixel i of the integer Bresenham line. The error-term loop on the CPU
+// always steps the major axis and puts the minor axis at
+// (2 * i * minor + major) / (2 * major), which is what we compute directly.
+void bresenham() {
+    ivec2 p0 = ivec2(roundHalfAway(aLine.x), roundHalfAway(aLine.y));
+    ivec2 p1 = ivec2(roundHalfAway(aLine.z), roundHalfAway(aLine.w));
+
+    int adx = abs(p1.x - p0.x);
+    int ady = abs(p1.y - p0.y);
+    int sx = p0.x < p1.x ? 1 : -1;
+    int sy = p0.y < p1.y ? 1 : -1;
+    int major = max(adx, ady);
+
+    int i = gl_VertexID;
+    if (i > major) { cull(); return; }
+
+    int f = major == 0 ? 0 : (2 * i * min(adx, ady) + major) / (2 * major);
+    ivec2 p = adx >= ady ? ivec2(p0.x + sx * i, p0.y + sy * f)
+                         : ivec2(p0.x + sx * f, p0.y + sy * i);
+
+    emit(vec2(p), vec4(0.0, 0.0, 0.0, 1.0));
+}
+
+// Two vertices per column: column 0 and 1 are the endpoints, then the main loop.
+// Same setup as xiaolinWuLine, but intery is evaluated in closed form per column.
+void xiaolinWu() {
+    float x0 = aLine.x, y0 = aLine.y, x1 = aLine.z, y1 = aLine.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = aLine.y; y0 = aLine.x; x1 = aLine.w; y1 = aLine.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float dy = y1 - y0;
+    float gradient = (dx == 0.0) ? 1.0 : (dy / dx);
+
+    int column = gl_VertexID / 2;
+    int upper = gl_VertexID % 2; // 0 = floor pixel, 1 = the one above
+
+    float xpxl1 = floor(x0);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+    float xpxl2 = ceil(x1);
+
+    float major, y, coverage;
+    if (column == 0) {
+        major = xpxl1;
+        y = yend1;
+        coverage = 1.0 - (x0 - xpxl1);
+    }
+    else if (column == 1) {
+        major = xpxl2;
+        y = y1 + gradient * (xpxl2 - x1);
+        coverage = 1.0 - (x1 - xpxl2);
+    }
+    else {
+        int x = int(xpxl1) + 1 + (column - 2);
+        if (x >= int(xpxl2)) { cull(); return; }
+        major = float(x);
+        y = yend1 + gradient * (major - xpxl1);
+        coverage = 1.0;
+    }
+
+    float minor = floor(y) + float(upper);
+    coverage *= upper == 1 ? fpart(y) : rfpart(y);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    emit(pixel, vec4(lineColor, coverage));
+}
+
+void main() {
+    if (lineMode == 0)
+        bresenham();
+    else
+        xiaolinWu();
+}
@@ -6,223 +6,115 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <iostream>
-#include <fstream>
-#include <sstream>
 
+#include <algorithm>
 #include <vector>
 #include <cmath>
-
-// Vertex structure for Xiaolin Wu lines
-struct Vertex {
-    float x, y;
-    float r, g, b;
-    float alpha;
+#include <cstddef>
+#include <cstring>
+#include <span>
+
+#include "BatchRasterizer.h"
+#include "CoverageBuffer.h"
+#include "DamageTracker.h"
+#include "FramePipeline.h"
+#include "FrameProfiler.h"
+#include "GeometryCache.h"
+#include "GpuLineRasterizer.h"
+#include "GpuSineRasterizer.h"
+#include "LineScene.h"
+#include "Polyline.h"
+#include "Rasterizer.h"
+#include "RenderTarget.h"
+#include "SceneTarget.h"
+#include "SeriesLod.h"
+#include "ShaderCache.h"
+#include "StreamBuffer.h"
+
+// Inputs of one frame of the CPU sine wave, captured when it is submitted
+struct SineParams {
+    int mode;          // SINE_MODE
+    bool packed;       // Wu as PackedVertex
+    int xStart, xEnd;
+    float amplitude, frequency, phase;
+    float zoom;        // SERIES_ZOOM
+    int targetWidth, targetHeight;
 };
 
-// Line structure for generating radial lines
-struct Line {
-    float x0, y0, x1, y1;
+// Vertices of each set of one frame of the CPU sine wave
+// (Bresenham pairs, and Wu or packed Wu, whichever the frame uses)
+struct SineCounts {
+    size_t bresenham, wu;
 };
 
-// Generate radial lines from center (x0, y0) with given radius and angle step
-std::vector<Line> generateLines(int x0, int y0, int radius, int angleStep) {
-    std::vector<Line> lines;
-    for (int angle = 0; angle < 360; angle += angleStep) {
-        double rad = angle * (3.14159) / 180.0;
-        float x1 = x0 + static_cast<float>(radius * cos(rad));
-        float y1 = y0 + static_cast<float>(radius * sin(rad));
-        lines.push_back({ static_cast<float>(x0), static_cast<float>(y0), x1, y1 });
-    }
-    return lines;
-}
-
-// Bresenham lines
-// Only uses integer arithmetic (other than NDC conversion)
-std::vector<float> bresenhamLine(int x0, int y0, int x1, int y1, int width, int height) {
-    std::vector<float> vertices;
-
-    int dx = std::abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
-    int dy = -std::abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
-    int err = dx + dy, e2;
-
-    while (true) {
-        float ndcX = (2.0f * (x0 + 0.5f)) / width - 1.0f;
-        float ndcY = (2.0f * (y0 + 0.5f)) / height - 1.0f;
-        vertices.push_back(ndcX);
-        vertices.push_back(ndcY);
-
-        if (x0 == x1 && y0 == y1) break;
-        e2 = 2 * err;
-        if (e2 >= dy) { err += dy; x0 += sx; }
-        if (e2 <= dx) { err += dx; y0 += sy; }
-    }
-
-    return vertices;
-}
-
-// Xiaolin Wu antialiasing
-std::vector<Vertex> xiaolinWuLine(float x0, float y0, float x1, float y1,
-    int width, int height,
-    float r = 1.0f, float g = 0.0f, float b = 1.0f) {
-    std::vector<Vertex> vertices;
-
-	// Helper functions
-	// fractional part (the bottom pixel coverage)
-	// note the use of std::floor to ensure correct behavior for negative values
-    auto fpart = [](float x) { return x - std::floor(x); };
-
-	// reverse fractional part (the top pixel coverage)
-	// this is a lambda to capture fpart
-	// we do this to avoid recomputing 1.0 - fpart(x) multiple times
-    auto rfpart = [&](float x) { return 1.0f - fpart(x); };
-
-	// Step 1 : Handle steep lines
-	// A line is steep if the absolute slope is greater than 1
-
-    bool steep = std::abs(y1 - y0) > std::abs(x1 - x0);
-
-    float X0 = x0, Y0 = y0, X1 = x1, Y1 = y1;
-    if (steep) {
-        std::swap(X0, Y0);
-        std::swap(X1, Y1);
-    }
-    if (X0 > X1) {
-        std::swap(X0, X1);
-        std::swap(Y0, Y1);
-    }
+// Geometry of one frame of the CPU sine wave, in its pipeline slot's arena
+struct SineFrame {
+    std::vector<Point> points; // polyline modes, kept with the slot so it stops allocating
+    std::span<float> bresenham;
+    std::span<Vertex> wu;
+    std::span<PackedVertex> wuPacked;
+};
 
-	// Step 2 : Compute the line parameters
-	// This means calculating the slope (gradient)
+// GLFW callbacks
+void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void mouse_callback(GLFWwindow* window, double xpos, double ypos);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
+void processInput(GLFWwindow* window);
 
-    float dx = X1 - X0;
-    float dy = Y1 - Y0;
-    float gradient = (dx == 0.0f) ? 1.0f : (dy / dx);
+// settings
+const unsigned int SCR_WIDTH = 1280; // initial window size
+const unsigned int SCR_HEIGHT = 720;
 
-	// Step 3 : Handle the endpoints
-	// We need to handle the first and last pixels separately
+// The scene's pixel sizes below are for a target of this size, they are
+// scaled to the real one so any window shows the same picture
+const float DESIGN_WIDTH = 1280.0f;
+const float DESIGN_HEIGHT = 720.0f;
 
-    // First endpoint
-    float xend = std::floor(X0);
-    float yend = Y0 + gradient * (xend - X0);
-    float xgap = 1.0f - (X0 - xend);
-    float xpxl1 = xend;
-    float ypxl1 = std::floor(yend);
+// Framebuffer size in pixels, kept up to date by framebuffer_size_callback
+int framebufferWidth = 0;
+int framebufferHeight = 0;
 
-    auto pushVertex = [&](float ndcX, float ndcY, float alpha) {
-        vertices.push_back({ ndcX, ndcY, r, g, b, alpha });
-    };
+// timing
+float deltaTime = 0.0f;
+float lastFrame = 0.0f;
 
-    if (steep) {
-        float ndcX1 = (2.0f * (ypxl1 + 0.5f)) / width - 1.0f;
-        float ndcY1 = (2.0f * (xpxl1 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX1, ndcY1, rfpart(yend) * xgap);
+// Curve switch
+int CURVE = 0; // Begins with sine wave
 
-        float ndcX2 = (2.0f * (ypxl1 + 1 + 0.5f)) / width - 1.0f;
-        float ndcY2 = (2.0f * (xpxl1 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX2, ndcY2, fpart(yend) * xgap);
-    }
-    else {
-        float ndcX1 = (2.0f * (xpxl1 + 0.5f)) / width - 1.0f;
-        float ndcY1 = (2.0f * (ypxl1 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX1, ndcY1, rfpart(yend) * xgap);
-
-        float ndcX2 = (2.0f * (xpxl1 + 0.5f)) / width - 1.0f;
-        float ndcY2 = (2.0f * (ypxl1 + 1 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX2, ndcY2, fpart(yend) * xgap);
-    }
+// Wu vertex format switch
+int WU_FORMAT = 0; // 0 = float Vertex, 1 = PackedVertex, 2 = PackedVertex from fixed-point Wu (radial lines)
 
-	float intery = yend + gradient; // first y-intersection for the main loop, after the first endpoint
+// Rasterization backend switch
+int BACKEND = 0; // 0 = CPU rasterizers, 1 = GPU vertex shaders (radial lines and sine wave)
 
-    // Second endpoint
-    xend = std::ceil(X1);
-    yend = Y1 + gradient * (xend - X1);
-    xgap = 1.0f - (X1 - xend);
-    float xpxl2 = xend;
-    float ypxl2 = std::floor(yend);
+// Sine wave sampling switch (CPU backend)
+int SINE_MODE = 0; // 0 = one sample per pixel column, 1 = adaptive polyline, 2 = dense series through the LOD pyramid
 
-    if (steep) {
-        float ndcX1 = (2.0f * (ypxl2 + 0.5f)) / width - 1.0f;
-        float ndcY1 = (2.0f * (xpxl2 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX1, ndcY1, rfpart(yend) * xgap);
+// Visible fraction of the dense series (mouse wheel zooms)
+float SERIES_ZOOM = 0.25f;
 
-        float ndcX2 = (2.0f * (ypxl2 + 1 + 0.5f)) / width - 1.0f;
-        float ndcY2 = (2.0f * (xpxl2 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX2, ndcY2, fpart(yend) * xgap);
-    }
-    else {
-        float ndcX1 = (2.0f * (xpxl2 + 0.5f)) / width - 1.0f;
-        float ndcY1 = (2.0f * (ypxl2 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX1, ndcY1, rfpart(yend) * xgap);
-
-        float ndcX2 = (2.0f * (xpxl2 + 0.5f)) / width - 1.0f;
-        float ndcY2 = (2.0f * (ypxl2 + 1 + 0.5f)) / height - 1.0f;
-        pushVertex(ndcX2, ndcY2, fpart(yend) * xgap);
-    }
+// Wu blending switch
+int COVERAGE_MODE = 0; // 0 = blend each line directly, 1 = max coverage buffer, 2 = additive coverage buffer
 
-    // Main loop
-	// Step 4 : Draw the line
-	// We must now draw the pixels between the two endpoints
-    if (steep) {
-        for (int x = int(xpxl1) + 1; x < int(xpxl2); ++x) {
-            float y = intery;
-			float ndcX1 = (2.0f * (std::floor(y) + 0.5f)) / width - 1.0f; // we swap x and y here (we are in steep mode)
-            float ndcY1 = (2.0f * (x + 0.5f)) / height - 1.0f;
-            pushVertex(ndcX1, ndcY1, rfpart(y));
-
-            float ndcX2 = (2.0f * (std::floor(y) + 1 + 0.5f)) / width - 1.0f;
-            float ndcY2 = (2.0f * (x + 0.5f)) / height - 1.0f;
-            pushVertex(ndcX2, ndcY2, fpart(y));
-
-            intery += gradient;
-        }
-    }
-    else {
-        for (int x = int(xpxl1) + 1; x < int(xpxl2); ++x) {
-            float y = intery;
-            float ndcX1 = (2.0f * (x + 0.5f)) / width - 1.0f;
-            float ndcY1 = (2.0f * (std::floor(y) + 0.5f)) / height - 1.0f;
-            pushVertex(ndcX1, ndcY1, rfpart(y));
-
-            float ndcX2 = (2.0f * (x + 0.5f)) / width - 1.0f;
-            float ndcY2 = (2.0f * (std::floor(y) + 1 + 0.5f)) / height - 1.0f;
-            pushVertex(ndcX2, ndcY2, fpart(y));
-
-            intery += gradient;
-        }
-    }
+// Wu geometry switch (radial lines)
+// Polylines stay on points: one independent quad per segment would blend
+// every joint twice, the point path draws it once (see Polyline.h).
+int WU_QUADS = 0; // 0 = one point per pixel, 1 = one quad per segment with coverage in the fragment shader
 
-    return vertices;
-}
+// Radial Wu lines as a batched scene with per-line color, width and opacity
+int SCENE = 0; // 1 = LineScene, one glMultiDrawArrays for every line
 
+// Partial redraw switch
+int DAMAGE_TRACKING = 1; // 1 = clear and redraw only what changed, 0 = every cell every frame
 
-// Shader loader
-std::string loadShaderSource(const char* filePath) {
-    std::ifstream file(filePath);
-    if (!file.is_open()) {
-        std::cerr << "ERROR: Could not open shader file: " << filePath << std::endl;
-        return "";
-    }
-    std::stringstream buffer;
-    buffer << file.rdbuf();
-    return buffer.str();
-}
+// Rasterizer output space switch
+int PIXEL_SPACE = 0; // 0 = CPU rasterizers emit NDC, 1 = integer pixels mapped by the pixelToNdc matrix
 
-// GLFW callbacks
-void framebuffer_size_callback(GLFWwindow* window, int width, int height);
-void mouse_callback(GLFWwindow* window, double xpos, double ypos);
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
-void processInput(GLFWwindow* window);
+// Frames of CPU sine geometry generated ahead on a worker thread
+int PIPELINE_DEPTH = 1; // 0 = generate, then draw on the render thread, 1-2 = frames ahead (and of latency)
 
-// settings
-const unsigned int SCR_WIDTH = 1280;
-const unsigned int SCR_HEIGHT = 720;
-
-// timing
-float deltaTime = 0.0f;
-float lastFrame = 0.0f;
-
-// Curve switch
-int CURVE = 0; // Begins with sine wave
+// Frame timing CSV switch
+int RECORD_TIMINGS = 0; // 1 = append every frame to frame_timings.csv
 
 int main()
 {
@@ -245,6 +137,7 @@ int main()
         return -1;
     }
     glfwMakeContextCurrent(window);
+    glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight); // differs from the window size on HiDPI screens
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetScrollCallback(window, scroll_callback);
@@ -263,6 +156,7 @@ int main()
     // Depth Test is disabled to ensure proper blending of Wu lines. This will make it look ugly (try it)
 	// In a real application you would probably want to sort
 	// the lines by depth before drawing to avoid this issue.
+	// Or accumulate coverage order-independently, see CoverageBuffer (key A).
 
 	// Characteristics of the lines when Depth Test is enabled:
 	// Flickering lines when they overlap
@@ -272,73 +166,296 @@ int main()
     //glEnable(GL_DEPTH_TEST);
 
     // Shaders
-    std::string vertexCode = loadShaderSource("vertex_shader.glsl");
-    std::string fragmentCode = loadShaderSource("fragment_shader.glsl");
+    // Sources are embedded in the executable, linked programs are cached on
+    // disk and loaded back as binaries by later runs on the same driver
+    ProgramCache programs;
+    programs.init(defaultShaderCacheDirectory());
 
-    const char* vShaderCode = vertexCode.c_str();
-    const char* fShaderCode = fragmentCode.c_str();
+    GLuint shaderProgram = programs.load("vertex_shader.glsl", "fragment_shader.glsl");
 
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vShaderCode, NULL);
-    glCompileShader(vertexShader);
+    // Packed Wu vertices do the NDC transform in their own vertex shader
+    GLuint packedProgram = programs.load("packed_vertex_shader.glsl", "fragment_shader.glsl");
 
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fShaderCode, NULL);
-    glCompileShader(fragmentShader);
+    // GPU backend rasterizes in its vertex shader from the line endpoints
+    GLuint gpuLineProgram = programs.load("gpu_line_vertex_shader.glsl", "fragment_shader.glsl");
 
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
+    // Wu quads: one quad per segment, coverage per fragment
+    GLuint gpuLineQuadProgram = programs.load("gpu_line_quad_vertex_shader.glsl", "gpu_line_quad_fragment_shader.glsl");
+
+    // Line scene: the same quads, endpoints and style fetched by line ID
+    GLuint sceneProgram = programs.load("scene_vertex_shader.glsl", "gpu_line_quad_fragment_shader.glsl");
+
+    // GPU sine evaluates the animated curve in its vertex shader
+    GLuint gpuSineProgram = programs.load("sine_vertex_shader.glsl", "fragment_shader.glsl");
+
+    // Resolve pass of the coverage accumulation buffer
+    GLuint resolveProgram = programs.load("resolve_vertex_shader.glsl", "resolve_fragment_shader.glsl");
+
+    if (!shaderProgram || !packedProgram || !gpuLineProgram || !gpuLineQuadProgram ||
+        !sceneProgram || !gpuSineProgram || !resolveProgram) {
+        // The ERROR above says which one and why
+        glfwTerminate();
+        return -1;
+    }
 
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
+    // ---------- Render target ----------
+    // Cell layout of the framebuffer, everything is rasterized at cell size
+    RenderTarget renderTarget;
+    renderTarget.init(framebufferWidth, framebufferHeight);
 
     // Generate initial vertices
     std::vector<float> verticesBresenham = bresenhamLine(50, 50, 750, 550, SCR_WIDTH, SCR_HEIGHT);
     std::vector<Vertex> verticesWu = xiaolinWuLine(50.0f, 50.0f, 750.0f, 550.0f, SCR_WIDTH, SCR_HEIGHT);
 
-    // Create VAO & VBO for Bresenham
-    GLuint VAO, VBO;
+    // Streaming buffers for the per-frame vertex uploads
+    StreamBuffer streamBresenham, streamWu, streamWuPacked;
+    streamBresenham.init(2 * sizeof(float), static_cast<GLsizei>(verticesBresenham.size() / 2));
+    streamWu.init(sizeof(Vertex), static_cast<GLsizei>(verticesWu.size()));
+    streamWuPacked.init(sizeof(PackedVertex), static_cast<GLsizei>(verticesWu.size()));
+
+    // Create VAO for Bresenham
+    GLuint VAO;
     glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
 
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, verticesBresenham.size() * sizeof(float), verticesBresenham.data(), GL_DYNAMIC_DRAW);
+    auto setupBresenhamAttributes = [](GLuint vao, GLuint buffer) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
 
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+        glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    };
+    setupBresenhamAttributes(VAO, streamBresenham.buffer());
 
-    // Create VAO & VBO for Xiaolin Wu
-    GLuint VAOWu, VBOWu;
+    // Create VAO for Xiaolin Wu
+    GLuint VAOWu;
     glGenVertexArrays(1, &VAOWu);
-    glGenBuffers(1, &VBOWu);
 
-    glBindVertexArray(VAOWu);
-    glBindBuffer(GL_ARRAY_BUFFER, VBOWu);
-    glBufferData(GL_ARRAY_BUFFER, verticesWu.size() * sizeof(Vertex), verticesWu.data(), GL_DYNAMIC_DRAW);
+    auto setupWuAttributes = [](GLuint vao, GLuint buffer) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+        // Position attribute (x,y)
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
+        glEnableVertexAttribArray(0);
+
+        // Color attribute (r,g,b,a)
+        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(float)));
+        glEnableVertexAttribArray(1);
+
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    };
+    setupWuAttributes(VAOWu, streamWu.buffer());
+
+    // Create VAO for packed Xiaolin Wu
+    GLuint VAOWuPacked;
+    glGenVertexArrays(1, &VAOWuPacked);
 
-    // Position attribute (x,y)
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    glEnableVertexAttribArray(0);
+    auto setupWuPackedAttributes = [](GLuint vao, GLuint buffer) {
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
 
-    // Color attribute (r,g,b,a)
-    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(2 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+        // Pixel attribute (int16 x,y), converted to float without normalization
+        glVertexAttribPointer(0, 2, GL_SHORT, GL_FALSE, sizeof(PackedVertex), (void*)0);
+        glEnableVertexAttribArray(0);
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+        // Coverage and color index (uint8, uint8)
+        glVertexAttribPointer(1, 2, GL_UNSIGNED_BYTE, GL_FALSE, sizeof(PackedVertex), (void*)offsetof(PackedVertex, coverage));
+        glEnableVertexAttribArray(1);
 
-    // Time uniform
-    GLint timeLoc = glGetUniformLocation(shaderProgram, "time");
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glBindVertexArray(0);
+    };
+    setupWuPackedAttributes(VAOWuPacked, streamWuPacked.buffer());
+
+    // ---------- Radial geometry cache ----------
+    // The radial scene doesn't move, it is rasterized and uploaded once
+    // into static buffers and redrawn from them until a parameter changes.
+    // Both Wu VAOs read the same buffer, the cached format picks one.
+    RadialGeometryCache radialCache;
+    radialCache.init();
+
+    GLuint VAOStatic[3];
+    glGenVertexArrays(3, VAOStatic);
+    setupBresenhamAttributes(VAOStatic[0], radialCache.bresenhamBuffer());
+    setupWuAttributes(VAOStatic[1], radialCache.wuBuffer());
+    setupWuPackedAttributes(VAOStatic[2], radialCache.wuBuffer());
+
+    // This frame's slice of count vertices in a stream buffer, which grows
+    // first if it can't hold them (a new GL buffer needs its attribute pointers
+    // set again). Returns the write pointer, nullptr if nothing can be written,
+    // first receives the first vertex index of the slice for glDrawArrays.
+    auto mapStream = [](StreamBuffer& stream, GLuint vao, auto&& setupAttributes, size_t count, GLint& first) {
+        if (stream.reserve(static_cast<GLsizei>(count))) setupAttributes(vao, stream.buffer());
+        return stream.map(static_cast<GLsizei>(count), first);
+    };
+
+    // Copy vertex data into this frame's slice, only for frames the pipeline
+    // worker generated ahead: their slices don't exist yet while they are
+    // generated. Returns the first vertex index of the slice.
+    auto streamVertices = [&](StreamBuffer& stream, GLuint vao, auto&& setupAttributes, const void* data, GLsizei count, GLsizei stride) {
+        GLint first = 0;
+        void* dst = mapStream(stream, vao, setupAttributes, count, first);
+        if (dst) {
+            std::memcpy(dst, data, static_cast<size_t>(count) * stride);
+            stream.unmap();
+        }
+        return first;
+    };
+
+    // ---------- Viewport cells ----------
+    // Each algorithm is drawn into two cells, the instance ID picks the cell
+    // The cell uniform block is at binding 0, kept by the render target.
+    glUniformBlockBinding(shaderProgram, glGetUniformBlockIndex(shaderProgram, "Cells"), 0);
+    glUniformBlockBinding(packedProgram, glGetUniformBlockIndex(packedProgram, "Cells"), 0);
+
+    GLint cellOffsetLoc = glGetUniformLocation(shaderProgram, "cellOffset");
+    GLint useCellColorLoc = glGetUniformLocation(shaderProgram, "useCellColor");
+    GLint pixelToNdcLoc = glGetUniformLocation(shaderProgram, "pixelToNdc");
+
+    // Pixel centers of the target to NDC, changes with its size
+    glm::mat4 pixelToNdc = renderTarget.pixelToNdc();
+    glm::mat4 identity = glm::mat4(1.0f);
+    GLint packedPixelToNdcLoc = glGetUniformLocation(packedProgram, "pixelToNdc");
+
+    // Packed program uniforms only change with the target size
+    // Color index 0 is the magenta used by the float path
+    glUseProgram(packedProgram);
+    glUniform1i(glGetUniformLocation(packedProgram, "cellOffset"), 2);
+    glUniformMatrix4fv(packedPixelToNdcLoc, 1, GL_FALSE, glm::value_ptr(pixelToNdc));
+    glUniform3f(glGetUniformLocation(packedProgram, "lineColors[0]"), 1.0f, 0.0f, 1.0f);
+    glUseProgram(0);
+
+    GpuLineRasterizer gpuRasterizer;
+    gpuRasterizer.init(gpuLineProgram, gpuLineQuadProgram, renderTarget.width(), renderTarget.height());
+
+    // Radial lines written one at a time straight into the GPU backend's stream slice
+    auto uploadRadialLines = [&gpuRasterizer](int centerX, int centerY, int radius, int angleStep) {
+        int count = generateLinesCount(angleStep);
+        if (!gpuRasterizer.beginUpload(count))
+            return;
+        for (int i = 0; i < count; ++i)
+            gpuRasterizer.add(radialLine(centerX, centerY, radius, angleStep, i));
+        gpuRasterizer.endUpload();
+    };
+
+    LineScene scene;
+    scene.init(sceneProgram, renderTarget.width(), renderTarget.height());
+
+    GpuSineRasterizer gpuSine;
+    gpuSine.init(gpuSineProgram, renderTarget.width(), renderTarget.height());
+
+    CoverageBuffer coverageBuffer;
+    coverageBuffer.init(resolveProgram, renderTarget.framebufferWidth(), renderTarget.framebufferHeight());
+
+    // Cells are drawn here and kept across frames, only damage is redrawn
+    SceneTarget sceneTarget;
+    sceneTarget.init(renderTarget.framebufferWidth(), renderTarget.framebufferHeight());
+    DamageTracker damage;
+    int lastSceneKey = -1;
 
     // Just to make it bigger
     glPointSize(1.0f);
 
+    // Per-frame scratch memory for vertex generation
+    // Grows to the scene's high-water mark once, then no frame allocates
+    FrameArena frameArena;
+
+    // ---------- Frame timing ----------
+    // CPU and GPU time of each stage, p50/p99 are shown in the window title
+    enum { SCOPE_GENERATE, SCOPE_UPLOAD, SCOPE_CLEAR, SCOPE_BRESENHAM, SCOPE_WU };
+    FrameProfiler profiler;
+    profiler.init({ "generate", "upload", "clear", "bresenham", "wu" });
+    float lastTitleUpdate = 0.0f;
+
+    // Dense series: a noisy sine with thousands of samples per pixel column,
+    // drawn through its M4 pyramid so the cost follows the window width
+    const size_t SERIES_SAMPLES = size_t(1) << 22;
+    std::vector<float> series(SERIES_SAMPLES);
+    for (size_t i = 0; i < SERIES_SAMPLES; ++i) {
+        float t = float(i) / float(SERIES_SAMPLES);
+        float noise = float((i * 2654435761u) % 1000) / 1000.0f - 0.5f;
+        series[i] = 0.8f * std::sin(40.0f * t) + 0.2f * noise;
+    }
+    SeriesPyramid seriesLod;
+    seriesLod.build(series);
+
+    // ---------- CPU sine geometry ----------
+    // Generated from its params alone (no GL calls): at depth 0 on this thread
+    // straight into the frame's stream slices, ahead of time on the pipeline
+    // worker into its slot's arena.
+
+    // Polyline of the curve modes, left empty for one sample per column
+    auto sinePoints = [&seriesLod, SERIES_SAMPLES](const SineParams& p, std::vector<Point>& points) {
+        points.clear();
+        if (p.mode == 1) {
+            // Sine wave as a polyline, tessellated to within a quarter pixel
+            // Unlike the per-column split this has no gaps where |dy/dx| > 1
+            tessellateCurve([&](float x) {
+                float y = p.targetHeight / 2 + p.amplitude * sin(p.frequency * x + p.phase);
+                return Point{ x, y };
+            }, float(p.xStart), float(p.xEnd), 0.25f, points);
+        }
+        else if (p.mode == 2) {
+            // Scrolling window of the dense series, at most 4 points per column
+            size_t visible = std::max<size_t>(64, static_cast<size_t>(SERIES_SAMPLES * p.zoom));
+            visible = std::min(visible, SERIES_SAMPLES);
+            size_t range = SERIES_SAMPLES - visible + 1;
+            size_t first = static_cast<size_t>(p.phase * 0.05f * float(visible)) % range;
+            seriesLod.decimate(first, first + visible, p.xStart, p.xEnd, p.targetHeight / 2, p.amplitude, points);
+        }
+    };
+
+    // Room each vertex set needs (an upper bound for the Wu polyline)
+    auto sineCounts = [](const SineParams& p, const std::vector<Point>& points) -> SineCounts {
+        if (p.mode >= 1)
+            return { polylineBresenhamCount(points), polylineWuBound(points) };
+        size_t samples = size_t(sineWaveCount({ p.xStart, p.xEnd, p.amplitude, p.frequency, p.phase }));
+        return { samples, 2 * samples };
+    };
+
+    // Writes the vertex sets into buffers of sineCounts() vertices, wu or
+    // wuPacked depending on p.packed, and returns how many were written.
+    // The buffers are only written, so they can be mapped GL memory.
+    auto writeSine = [](const SineParams& p, const std::vector<Point>& points, FrameArena& scratch,
+        float* bresenham, Vertex* wu, PackedVertex* wuPacked) -> SineCounts {
+        SineCounts written = { 0, 0 };
+        if (p.mode >= 1) {
+            if (bresenham) written.bresenham = size_t(rasterizePolylineBresenham(points, p.targetWidth, p.targetHeight, bresenham) - bresenham) / 2;
+            if (p.packed && wuPacked) written.wu = size_t(rasterizePolylinePacked(points, scratch, wuPacked) - wuPacked);
+            if (!p.packed && wu) written.wu = size_t(rasterizePolyline(points, p.targetWidth, p.targetHeight, scratch, wu) - wu);
+        }
+        else {
+            // Sine wave, one sample per pixel column
+            SineWave wave = { p.xStart, p.xEnd, p.amplitude, p.frequency, p.phase };
+            if (bresenham) written.bresenham = size_t(sineWaveBresenham(wave, p.targetWidth, p.targetHeight, bresenham) - bresenham) / 2;
+            if (p.packed && wuPacked) written.wu = size_t(sineWaveWuPacked(wave, p.targetHeight, wuPacked) - wuPacked);
+            if (!p.packed && wu) written.wu = size_t(sineWaveWu(wave, p.targetWidth, p.targetHeight, wu) - wu);
+        }
+        return written;
+    };
+
+    // Frames generated ahead can't write into slices that don't exist yet,
+    // the worker fills the slot's arena and the render loop copies it
+    auto generateSine = [&sinePoints, &sineCounts, &writeSine](const SineParams& p, SineFrame& frame, FrameArena& arena) {
+        sinePoints(p, frame.points);
+        SineCounts room = sineCounts(p, frame.points);
+        float* bresenham = arena.allocate<float>(2 * room.bresenham).data();
+        Vertex* wu = p.packed ? nullptr : arena.allocate<Vertex>(room.wu).data();
+        PackedVertex* wuPacked = p.packed ? arena.allocate<PackedVertex>(room.wu).data() : nullptr;
+
+        SineCounts written = writeSine(p, frame.points, arena, bresenham, wu, wuPacked);
+        frame.bresenham = std::span<float>(bresenham, 2 * written.bresenham);
+        frame.wu = p.packed ? std::span<Vertex>() : std::span<Vertex>(wu, written.wu);
+        frame.wuPacked = p.packed ? std::span<PackedVertex>(wuPacked, written.wu) : std::span<PackedVertex>();
+    };
+
+    FramePipeline<SineFrame, SineParams> sinePipeline(generateSine);
+    std::vector<Point> sineFramePoints; // depth 0, kept so it stops allocating
+
     // render loop
     while (!glfwWindowShouldClose(window))
     {
@@ -346,156 +463,394 @@ int main()
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
 
+        // ---------- Resize ----------
+        // Everything sized to the target is reallocated once per new size,
+        // the cached radial geometry rebuilds itself from its params
+        if (renderTarget.resize(framebufferWidth, framebufferHeight) && !renderTarget.isEmpty()) {
+            int w = renderTarget.width(), h = renderTarget.height();
+            pixelToNdc = renderTarget.pixelToNdc();
+            glUseProgram(packedProgram);
+            glUniformMatrix4fv(packedPixelToNdcLoc, 1, GL_FALSE, glm::value_ptr(pixelToNdc));
+            gpuRasterizer.setTargetSize(w, h);
+            gpuSine.setTargetSize(w, h);
+            scene.setTargetSize(w, h);
+            scene.clear(); // rebuilt for the new size below
+            coverageBuffer.resize(renderTarget.framebufferWidth(), renderTarget.framebufferHeight());
+            sceneTarget.resize(renderTarget.framebufferWidth(), renderTarget.framebufferHeight());
+            lastSceneKey = -1; // redraw everything, drop frames generated for the old size
+        }
+
+        // Minimized: nothing to draw until the window comes back
+        if (renderTarget.isEmpty()) {
+            glfwWaitEvents();
+            continue;
+        }
+
         processInput(window);
         glUseProgram(shaderProgram);
 
+        // Any switch changes the picture: everything is redrawn, and frames
+        // generated ahead with the old settings are dropped before the
+        // rasterizer settings below change under the worker
+        const int targetWidth = renderTarget.width();
+        const int targetHeight = renderTarget.height();
+        const ClipRect fullTarget = { 0, 0, targetWidth, targetHeight };
+        int sceneKey = CURVE + 2 * (WU_FORMAT + 3 * (BACKEND + 2 * (SINE_MODE + 3 * (COVERAGE_MODE
+            + 3 * (WU_QUADS + 2 * (SCENE + 2 * (PIXEL_SPACE + 2 * DAMAGE_TRACKING)))))));
+        if (sceneKey != lastSceneKey) {
+            damage.invalidate(fullTarget);
+            sinePipeline.flush();
+            lastSceneKey = sceneKey;
+        }
+        if (sinePipeline.depth() != PIPELINE_DEPTH)
+            sinePipeline.setDepth(PIPELINE_DEPTH);
+
+        // The float geometry comes in the space the rasterizers were switched to
+        setOutputSpace(PIXEL_SPACE == 1 ? OutputSpace::Pixels : OutputSpace::Ndc);
+        glUniformMatrix4fv(pixelToNdcLoc, 1, GL_FALSE, glm::value_ptr(PIXEL_SPACE == 1 ? pixelToNdc : identity));
+
+        if (RECORD_TIMINGS == 1 && !profiler.isRecording()) {
+            if (!profiler.startCsv("frame_timings.csv")) RECORD_TIMINGS = 0;
+        }
+        if (RECORD_TIMINGS == 0 && profiler.isRecording()) {
+            profiler.stopCsv();
+            std::cout << profiler.summary();
+        }
+        profiler.beginFrame();
+
         // ---------- Animate sine wave ----------
-        int x_start = 50;
-        int x_end = SCR_WIDTH - 50;
-        float amplitude = 200.0f;  // pixels
-        float frequency = 0.01f;   // controls wavelength
+        // Scaled from the design size, per axis
+        float scaleX = float(targetWidth) / DESIGN_WIDTH;
+        float scaleY = float(targetHeight) / DESIGN_HEIGHT;
+        int x_start = static_cast<int>(50.0f * scaleX);
+        int x_end = targetWidth - x_start;
+        float amplitude = 200.0f * scaleY;  // pixels
+        float frequency = 0.01f / scaleX;   // controls wavelength
         float phase = currentFrame; // animate
 
 		// ---------- Radial lines ----------
-        int radius = 800;
+        int radius = static_cast<int>(800.0f * std::max(scaleX, scaleY));
         int angleStep = 15; // every 15 degrees
+        int centerX = targetWidth / 2, centerY = targetHeight / 2;
 
         // ---------- Generate vertices depending on CURVE ----------
 
-        std::vector<Vertex> verticesWu;
-        std::vector<float> verticesBresenham;
-
-        if (CURVE == 0) {
-            // Sine wave
-            // Note that we sample at every pixel column so Wu can blend adjacent pixels
-            int num_points = x_end - x_start + 1; // one sample per pixel
-            for (int i = 0; i < num_points; ++i) {
-                float x = x_start + i; 
-                float y = SCR_HEIGHT / 2 + amplitude * sin(frequency * x + phase);
-
-                // Bresenham: just pixel centers (one vertex per column)
-                float ndcX = (2.0f * (x + 0.5f)) / SCR_WIDTH - 1.0f;
-                float ndcY = (2.0f * (y + 0.5f)) / SCR_HEIGHT - 1.0f;
-                verticesBresenham.push_back(ndcX);
-                verticesBresenham.push_back(ndcY);
-
-                // Wu: use floor + fractional part (dont round)
-                float y_floor = std::floor(y);
-                float frac = y - y_floor; // 0..1
-                float ndcXw = (2.0f * (x + 0.5f)) / SCR_WIDTH - 1.0f;
-
-                float ndcY1 = (2.0f * (y_floor + 0.5f)) / SCR_HEIGHT - 1.0f;        // lower (floor) pixel
-                verticesWu.push_back({ ndcXw, ndcY1, 1.0f, 0.0f, 1.0f, (1.0f - frac) });
-
-                float ndcY2 = (2.0f * (y_floor + 1 + 0.5f)) / SCR_HEIGHT - 1.0f;    // upper (ceil) pixel
-                verticesWu.push_back({ ndcXw, ndcY2, 1.0f, 0.0f, 1.0f, frac });
+        profiler.begin(SCOPE_GENERATE);
+
+        // Scratch memory of everything generated on this thread
+        frameArena.reset();
+
+        // Geometry generated on this thread goes straight into this frame's
+        // stream slices, the pipeline's is copied into them at upload
+        streamBresenham.beginFrame();
+        streamWu.beginFrame();
+        streamWuPacked.beginFrame();
+        GLint firstBresenham = 0, firstWu = 0;
+        GLsizei bresenhamCount = 0, wuCount = 0;
+        const std::vector<Point>* curvePoints = nullptr; // polyline of the sine modes, for the damage
+        SineFrame* sineFrame = nullptr; // held from the pipeline until uploaded
+
+        bool packed = (WU_FORMAT >= 1);
+        bool fixedPoint = (WU_FORMAT == 2);
+        bool gpuLines = (BACKEND == 1 && CURVE == 1);
+        bool gpuSineWave = (BACKEND == 1 && CURVE == 0);
+        bool wuQuads = (WU_QUADS == 1 && CURVE == 1);
+        bool sceneLines = (SCENE == 1 && CURVE == 1);
+
+        // The scene is static, built on first use and redrawn from its buffers
+        if (sceneLines && scene.size() == 0) {
+            std::span<Line> lines = generateLines(centerX, centerY, radius, angleStep, frameArena);
+            for (size_t i = 0; i < lines.size(); ++i) {
+                // Hue around the circle, widths 1 to 3 pixels, every third line half transparent
+                float hue = 6.0f * float(i) / float(lines.size());
+                float r = std::clamp(std::abs(hue - 3.0f) - 1.0f, 0.0f, 1.0f);
+                float g = std::clamp(2.0f - std::abs(hue - 2.0f), 0.0f, 1.0f);
+                float b = std::clamp(2.0f - std::abs(hue - 4.0f), 0.0f, 1.0f);
+                scene.add(lines[i], { r, g, b, i % 3 == 2 ? 0.5f : 1.0f, 1.0f + float(i % 5) * 0.5f });
             }
         }
+
+        gpuRasterizer.beginFrame();
+
+        if (gpuSineWave) {
+            // The columns are uploaded once, only the phase changes per frame
+            SineWave wave = { x_start, x_end, amplitude, frequency, phase };
+            gpuSine.setWave(wave);
+        }
+        else if (CURVE == 0 && sinePipeline.depth() == 0) {
+            // Nothing ahead: generated right here, into the mapped slices
+            SineParams params = { SINE_MODE, packed, x_start, x_end, amplitude, frequency, phase, SERIES_ZOOM, targetWidth, targetHeight };
+            sinePoints(params, sineFramePoints);
+            SineCounts room = sineCounts(params, sineFramePoints);
+            GLint firstWuPacked = 0;
+            float* bresenham = static_cast<float*>(mapStream(streamBresenham, VAO, setupBresenhamAttributes, room.bresenham, firstBresenham));
+            Vertex* wu = packed ? nullptr : static_cast<Vertex*>(mapStream(streamWu, VAOWu, setupWuAttributes, room.wu, firstWu));
+            PackedVertex* wuPacked = packed ? static_cast<PackedVertex*>(mapStream(streamWuPacked, VAOWuPacked, setupWuPackedAttributes, room.wu, firstWuPacked)) : nullptr;
+
+            SineCounts written = writeSine(params, sineFramePoints, frameArena, bresenham, wu, wuPacked);
+            if (bresenham) streamBresenham.unmap();
+            if (wu) streamWu.unmap();
+            if (wuPacked) streamWuPacked.unmap();
+            bresenhamCount = static_cast<GLsizei>(written.bresenham);
+            wuCount = static_cast<GLsizei>(written.wu);
+            if (packed) firstWu = firstWuPacked;
+            curvePoints = &sineFramePoints;
+        }
+        else if (CURVE == 0) {
+            // This frame's geometry was generated while the previous ones drew,
+            // the next ones are queued behind it.
+            // Frames ahead are animated to the time they will be shown at.
+            SineParams params = { SINE_MODE, packed, x_start, x_end, amplitude, frequency, phase, SERIES_ZOOM, targetWidth, targetHeight };
+            auto submitAhead = [&](int framesAhead) {
+                SineParams p = params;
+                p.phase += float(framesAhead) * deltaTime;
+                sinePipeline.submit(p);
+            };
+            if (sinePipeline.inFlight() == 0)
+                submitAhead(0);
+            sineFrame = &sinePipeline.acquire();
+            while (sinePipeline.inFlight() <= sinePipeline.depth())
+                submitAhead(sinePipeline.inFlight());
+            curvePoints = &sineFrame->points;
+        }
+        else if (gpuLines) {
+            // Only the endpoints go to the GPU, the vertex shader does the rest
+            uploadRadialLines(centerX, centerY, radius, angleStep);
+        }
         else {
-            auto lines = generateLines(SCR_WIDTH / 2, SCR_HEIGHT / 2, radius, angleStep);
-
-            for (const auto& line : lines) {
-                // Bresenham needs integer endpoints; round subpixel endpoints for it
-                auto bresenhamVerts = bresenhamLine(
-                    static_cast<int>(std::round(line.x0)),
-                    static_cast<int>(std::round(line.y0)),
-                    static_cast<int>(std::round(line.x1)),
-                    static_cast<int>(std::round(line.y1)),
-                    SCR_WIDTH, SCR_HEIGHT);
-                verticesBresenham.insert(verticesBresenham.end(), bresenhamVerts.begin(), bresenhamVerts.end());
-
-                // Wu: pass float endpoints so algorithm computes correct fractional coverage
-                auto wuVerts = xiaolinWuLine(line.x0, line.y0, line.x1, line.y1, SCR_WIDTH, SCR_HEIGHT, 1.0f, 0.0f, 1.0f);
-                verticesWu.insert(verticesWu.end(), wuVerts.begin(), wuVerts.end());
-            }
+            // Batch rasterization (Bresenham and Wu with float endpoints) into the
+            // static buffers, only on the first frame or when a parameter changed
+            RadialParams params = { centerX, centerY, radius, angleStep, targetWidth, targetHeight, packed, fixedPoint, PIXEL_SPACE == 1 };
+            radialCache.update(params, frameArena);
+            if (wuQuads) uploadRadialLines(centerX, centerY, radius, angleStep);
+        }
+        bool cached = (CURVE == 1 && !gpuLines);
+
+        profiler.end(SCOPE_GENERATE);
+
+        // ---------- Upload each vertex set once ----------
+        // Only frames from the pipeline worker are copied, everything else
+        // was written into its slice while it was generated
+        profiler.begin(SCOPE_UPLOAD);
+        if (sineFrame) {
+            bresenhamCount = static_cast<GLsizei>(sineFrame->bresenham.size() / 2);
+            wuCount = static_cast<GLsizei>(packed ? sineFrame->wuPacked.size() : sineFrame->wu.size());
+            firstBresenham = streamVertices(streamBresenham, VAO, setupBresenhamAttributes, sineFrame->bresenham.data(), bresenhamCount, 2 * sizeof(float));
+            firstWu = packed
+                ? streamVertices(streamWuPacked, VAOWuPacked, setupWuPackedAttributes, sineFrame->wuPacked.data(), wuCount, sizeof(PackedVertex))
+                : streamVertices(streamWu, VAOWu, setupWuAttributes, sineFrame->wu.data(), wuCount, sizeof(Vertex));
         }
 
-        // ---------- Cell 1: Top-left (Bresenham, white background) ----------
-        glViewport(0, SCR_HEIGHT / 2, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glEnable(GL_SCISSOR_TEST);
+        // Cached geometry draws from the start of its static buffers
+        GLuint bresenhamVAO = VAO;
+        GLuint wuVAO = packed ? VAOWuPacked : VAOWu;
+        if (cached) {
+            firstBresenham = 0;
+            firstWu = 0;
+            bresenhamCount = radialCache.bresenhamCount();
+            wuCount = radialCache.wuCount();
+            bresenhamVAO = VAOStatic[0];
+            wuVAO = packed ? VAOStatic[2] : VAOStatic[1];
+        }
+        profiler.end(SCOPE_UPLOAD);
+
+        // ---------- Damage ----------
+        // Only what changed since the last frame is cleared and redrawn, the
+        // rest of every cell is kept in the scene target. The radial lines
+        // don't move, they are redrawn only when a switch changes the picture.
+        if (CURVE == 0) {
+            if (curvePoints && !curvePoints->empty()) {
+                Point lo = (*curvePoints)[0], hi = (*curvePoints)[0];
+                for (const Point& p : *curvePoints) {
+                    lo = { std::min(lo.x, p.x), std::min(lo.y, p.y) };
+                    hi = { std::max(hi.x, p.x), std::max(hi.y, p.y) };
+                }
+                damage.add(xiaolinWuLineBounds(lo.x, lo.y, hi.x, hi.y));
+            }
+            else {
+                // Per-column samples stay within the amplitude
+                float center = float(targetHeight / 2);
+                damage.add(xiaolinWuLineBounds(float(x_start), center - amplitude, float(x_end), center + amplitude));
+            }
+        }
+        ClipRect redraw = intersect(damage.endFrame(), fullTarget);
+        if (DAMAGE_TRACKING == 0) redraw = fullTarget;
 
-        // For Bresenham draws we don't have per-vertex color attribute data,
-        // so we use the generic vertex attribute value at location 1 to supply a constant color.
-        glBindVertexArray(VAO);
-        glDisableVertexAttribArray(1); // ensure attribute array 1 is disabled for this VAO
-        glVertexAttrib4f(1, 0.0f, 0.0f, 0.0f, 1.0f); // black
+        // Uploaded, the slot can take a frame ahead again
+        if (sineFrame) sinePipeline.release();
 
-        glScissor(0, SCR_HEIGHT / 2, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glDisable(GL_SCISSOR_TEST);
+        // Damage in framebuffer pixels, every cell shows the target one to one
+        auto cellDamage = [&](const Cell& cell) {
+            ClipRect r = { cell.x + redraw.x0, cell.y + redraw.y0, cell.x + redraw.x1, cell.y + redraw.y1 };
+            return isEmpty(redraw) ? ClipRect{ 0, 0, 0, 0 } : intersect(r, { cell.x, cell.y, cell.x + cell.width, cell.y + cell.height });
+        };
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, verticesBresenham.size() * sizeof(float),
-            verticesBresenham.data(), GL_DYNAMIC_DRAW);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_POINTS, 0, verticesBresenham.size() / 2);
+        sceneTarget.bind();
 
-        // ---------- Cell 2: Bottom-left (Bresenham, black background) ----------
-        glViewport(0, 0, SCR_WIDTH / 2, SCR_HEIGHT / 2);
+        // ---------- Clear the damaged part of the four cells ----------
+        // Cell 1: Top-left (Bresenham, white background)
+        // Cell 2: Bottom-left (Bresenham, black background)
+        // Cell 3: Top-right (Wu, white background)
+        // Cell 4: Bottom-right (Wu, black background)
+        profiler.begin(SCOPE_CLEAR);
         glEnable(GL_SCISSOR_TEST);
+        ClipRect cellRedraw[4];
+        for (int i = 0; i < 4; ++i) {
+            const Cell& cell = renderTarget.cell(i);
+            cellRedraw[i] = cellDamage(cell);
+            if (isEmpty(cellRedraw[i]))
+                continue;
+            const ClipRect& r = cellRedraw[i];
+            glScissor(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+            glClearColor(cell.background[0], cell.background[1], cell.background[2], cell.background[3]);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+        profiler.end(SCOPE_CLEAR);
+
+        // ---------- Draw both cells of each algorithm in one instanced call ----------
+        // The viewport covers the whole window, the vertex shader places each
+        // instance in its cell and clips it to the cell edges.
+        glViewport(0, 0, renderTarget.framebufferWidth(), renderTarget.framebufferHeight());
+
+        // Bresenham has no per-vertex color, each cell supplies a constant one
+        auto drawBresenham = [&]() {
+            for (int i = 0; i < 4; ++i) glEnable(GL_CLIP_DISTANCE0 + i);
+            if (gpuLines) {
+                gpuRasterizer.drawBresenham(0);
+            }
+            else if (gpuSineWave) {
+                gpuSine.drawBresenham(0);
+            }
+            else {
+                glUseProgram(shaderProgram);
+                glUniform1i(cellOffsetLoc, 0);
+                glUniform1i(useCellColorLoc, GL_TRUE);
+                glBindVertexArray(bresenhamVAO);
+                glDrawArraysInstanced(GL_POINTS, firstBresenham, bresenhamCount, 2);
+            }
+            for (int i = 0; i < 4; ++i) glDisable(GL_CLIP_DISTANCE0 + i);
+        };
 
-        // Set constant yellow for this draw
-        glBindVertexArray(VAO);
-        glDisableVertexAttribArray(1);
-        glVertexAttrib4f(1, 1.0f, 1.0f, 0.0f, 1.0f); // yellow
-
-        glScissor(0, 0, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glDisable(GL_SCISSOR_TEST);
+        // ---------- Wu rendering ----------
+        auto drawWu = [&]() {
+            for (int i = 0; i < 4; ++i) glEnable(GL_CLIP_DISTANCE0 + i);
+            bool accumulate = (COVERAGE_MODE != 0);
+            if (accumulate) {
+                // Overlaps combine the same way whatever the draw order
+                coverageBuffer.begin(COVERAGE_MODE == 1 ? CoverageBuffer::Mode::Max : CoverageBuffer::Mode::Additive);
+            }
+            else {
+                glEnable(GL_BLEND);
+                glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+            }
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, verticesBresenham.size() * sizeof(float),
-            verticesBresenham.data(), GL_DYNAMIC_DRAW);
-        glBindVertexArray(VAO);
-        glDrawArrays(GL_POINTS, 0, verticesBresenham.size() / 2);
+            if (sceneLines) {
+                scene.draw(2, COVERAGE_MODE);
+            }
+            else if (wuQuads) {
+                gpuRasterizer.drawWuQuads(2, 1.0f, 0.0f, 1.0f, COVERAGE_MODE);
+            }
+            else if (gpuLines) {
+                gpuRasterizer.drawWu(2, 1.0f, 0.0f, 1.0f);
+            }
+            else if (gpuSineWave) {
+                gpuSine.drawWu(2, 1.0f, 0.0f, 1.0f);
+            }
+            else {
+                if (packed) {
+                    glUseProgram(packedProgram);
+                }
+                else {
+                    glUseProgram(shaderProgram);
+                    glUniform1i(cellOffsetLoc, 2);
+                    glUniform1i(useCellColorLoc, GL_FALSE);
+                }
+                glBindVertexArray(wuVAO);
+                glDrawArraysInstanced(GL_POINTS, firstWu, wuCount, 2);
+            }
 
+            if (accumulate) coverageBuffer.end();
+            glDisable(GL_BLEND);
+            for (int i = 0; i < 4; ++i) glDisable(GL_CLIP_DISTANCE0 + i);
+
+            // One full-screen pass turns the accumulated coverage into color
+            if (accumulate) coverageBuffer.resolve();
+        };
+
+        // A whole redraw is one pass per algorithm, a partial one a pass per
+        // damaged cell with the scissor keeping the instance of the other cell out
+        bool whole = (redraw.x0 == fullTarget.x0 && redraw.y0 == fullTarget.y0 && redraw.x1 == fullTarget.x1 && redraw.y1 == fullTarget.y1);
+        auto drawCells = [&](int firstCell, auto&& draw) {
+            if (whole) {
+                glDisable(GL_SCISSOR_TEST);
+                draw();
+                return;
+            }
+            for (int i = firstCell; i < firstCell + 2; ++i) {
+                if (isEmpty(cellRedraw[i]))
+                    continue;
+                const ClipRect& r = cellRedraw[i];
+                glEnable(GL_SCISSOR_TEST);
+                glScissor(r.x0, r.y0, r.x1 - r.x0, r.y1 - r.y0);
+                draw();
+            }
+        };
 
-        // ---------- Wu rendering ----------
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        profiler.begin(SCOPE_BRESENHAM);
+        drawCells(0, drawBresenham);
+        profiler.end(SCOPE_BRESENHAM);
 
-        // Cell 3: Top-right (Wu, white background)
-        glViewport(SCR_WIDTH / 2, SCR_HEIGHT / 2, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(SCR_WIDTH / 2, SCR_HEIGHT / 2, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        profiler.begin(SCOPE_WU);
+        drawCells(2, drawWu);
         glDisable(GL_SCISSOR_TEST);
+        profiler.end(SCOPE_WU);
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBOWu);
-        glBufferData(GL_ARRAY_BUFFER, verticesWu.size() * sizeof(Vertex),
-            verticesWu.data(), GL_DYNAMIC_DRAW);
-        glBindVertexArray(VAOWu);
-        glDrawArrays(GL_POINTS, 0, verticesWu.size());
+        // Unchanged pixels come from earlier frames
+        sceneTarget.present();
 
-        // Cell 4: Bottom-right (Wu, black background)
-        glViewport(SCR_WIDTH / 2, 0, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glEnable(GL_SCISSOR_TEST);
-        glScissor(SCR_WIDTH / 2, 0, SCR_WIDTH / 2, SCR_HEIGHT / 2);
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-        glDisable(GL_SCISSOR_TEST);
+        // Fence this frame's slices so they aren't overwritten while the GPU reads them
+        streamBresenham.endFrame();
+        streamWu.endFrame();
+        streamWuPacked.endFrame();
+        gpuRasterizer.endFrame();
 
-        glBindBuffer(GL_ARRAY_BUFFER, VBOWu);
-        glBufferData(GL_ARRAY_BUFFER, verticesWu.size() * sizeof(Vertex),
-            verticesWu.data(), GL_DYNAMIC_DRAW);
-        glBindVertexArray(VAOWu);
-        glDrawArrays(GL_POINTS, 0, verticesWu.size());
-
-        glDisable(GL_BLEND);
+        profiler.endFrame(deltaTime);
+        if (currentFrame - lastTitleUpdate > 0.5f) {
+            glfwSetWindowTitle(window, ("Bresenham Lines | " + profiler.titleSummary()).c_str());
+            lastTitleUpdate = currentFrame;
+        }
 
         // Swap buffers and poll events
         glfwSwapBuffers(window);
         glfwPollEvents();
     }
 
+    std::cout << "Frame arena peak usage: " << frameArena.peak() << " bytes" << std::endl;
+    std::cout << profiler.summary();
+
     // Clean up
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
     glDeleteVertexArrays(1, &VAOWu);
-    glDeleteBuffers(1, &VBOWu);
+    glDeleteVertexArrays(1, &VAOWuPacked);
+    glDeleteVertexArrays(3, VAOStatic);
+    radialCache.destroy();
+    renderTarget.destroy();
+    streamBresenham.destroy();
+    streamWu.destroy();
+    streamWuPacked.destroy();
+    glDeleteProgram(shaderProgram);
+    glDeleteProgram(packedProgram);
+    gpuRasterizer.destroy();
+    glDeleteProgram(gpuLineProgram);
+    glDeleteProgram(gpuLineQuadProgram);
+    scene.destroy();
+    glDeleteProgram(sceneProgram);
+    gpuSine.destroy();
+    glDeleteProgram(gpuSineProgram);
+    coverageBuffer.destroy();
+    sceneTarget.destroy();
+    glDeleteProgram(resolveProgram);
+    profiler.destroy();
 
     glfwTerminate();
     return 0;
@@ -518,16 +873,145 @@ void processInput(GLFWwindow* window)
     if (cState == GLFW_RELEASE) {
         cWasPressed = false;
     }
+
+    static bool pWasPressed = false;
+
+    int pState = glfwGetKey(window, GLFW_KEY_P);
+    if (pState == GLFW_PRESS && !pWasPressed) {
+        WU_FORMAT = (WU_FORMAT + 1) % 3; // Cycle float, packed and fixed-point packed Wu vertices
+        const char* names[] = { "float", "packed", "fixed-point packed" };
+        std::cout << "WU_FORMAT switched to " << names[WU_FORMAT] << std::endl;
+        pWasPressed = true;
+    }
+    if (pState == GLFW_RELEASE) {
+        pWasPressed = false;
+    }
+
+    static bool gWasPressed = false;
+
+    int gState = glfwGetKey(window, GLFW_KEY_G);
+    if (gState == GLFW_PRESS && !gWasPressed) {
+        BACKEND = (BACKEND + 1) % 2; // Toggle between CPU and GPU line rasterization
+        std::cout << "BACKEND switched to " << (BACKEND == 0 ? "CPU" : "GPU") << std::endl;
+        gWasPressed = true;
+    }
+    if (gState == GLFW_RELEASE) {
+        gWasPressed = false;
+    }
+
+    static bool lWasPressed = false;
+
+    int lState = glfwGetKey(window, GLFW_KEY_L);
+    if (lState == GLFW_PRESS && !lWasPressed) {
+        SINE_MODE = (SINE_MODE + 1) % 3; // Cycle per-column samples, the adaptive polyline and the dense series
+        const char* names[] = { "per-column", "polyline", "dense series (M4 LOD)" };
+        std::cout << "SINE_MODE switched to " << names[SINE_MODE] << std::endl;
+        lWasPressed = true;
+    }
+    if (lState == GLFW_RELEASE) {
+        lWasPressed = false;
+    }
+
+    static bool aWasPressed = false;
+
+    int aState = glfwGetKey(window, GLFW_KEY_A);
+    if (aState == GLFW_PRESS && !aWasPressed) {
+        COVERAGE_MODE = (COVERAGE_MODE + 1) % 3; // Cycle direct blending, max and additive coverage
+        const char* names[] = { "direct", "max coverage", "additive coverage" };
+        std::cout << "COVERAGE_MODE switched to " << names[COVERAGE_MODE] << std::endl;
+        aWasPressed = true;
+    }
+    if (aState == GLFW_RELEASE) {
+        aWasPressed = false;
+    }
+
+    static bool qWasPressed = false;
+
+    int qState = glfwGetKey(window, GLFW_KEY_Q);
+    if (qState == GLFW_PRESS && !qWasPressed) {
+        WU_QUADS = (WU_QUADS + 1) % 2; // Toggle Wu points and Wu quads
+        std::cout << "WU_QUADS switched to " << (WU_QUADS == 0 ? "points" : "quads") << std::endl;
+        qWasPressed = true;
+    }
+    if (qState == GLFW_RELEASE) {
+        qWasPressed = false;
+    }
+
+    static bool dWasPressed = false;
+
+    int dState = glfwGetKey(window, GLFW_KEY_D);
+    if (dState == GLFW_PRESS && !dWasPressed) {
+        DAMAGE_TRACKING = (DAMAGE_TRACKING + 1) % 2; // Toggle partial and full redraws
+        std::cout << "DAMAGE_TRACKING switched to " << (DAMAGE_TRACKING == 0 ? "off" : "on") << std::endl;
+        dWasPressed = true;
+    }
+    if (dState == GLFW_RELEASE) {
+        dWasPressed = false;
+    }
+
+    static bool mWasPressed = false;
+
+    int mState = glfwGetKey(window, GLFW_KEY_M);
+    if (mState == GLFW_PRESS && !mWasPressed) {
+        SCENE = (SCENE + 1) % 2; // Toggle the batched multi-color scene
+        std::cout << "SCENE switched to " << (SCENE == 0 ? "off" : "multi-draw") << std::endl;
+        mWasPressed = true;
+    }
+    if (mState == GLFW_RELEASE) {
+        mWasPressed = false;
+    }
+
+    static bool nWasPressed = false;
+
+    int nState = glfwGetKey(window, GLFW_KEY_N);
+    if (nState == GLFW_PRESS && !nWasPressed) {
+        PIXEL_SPACE = (PIXEL_SPACE + 1) % 2; // Toggle NDC and pixel space rasterizer output
+        std::cout << "PIXEL_SPACE switched to " << (PIXEL_SPACE == 0 ? "NDC" : "pixels") << std::endl;
+        nWasPressed = true;
+    }
+    if (nState == GLFW_RELEASE) {
+        nWasPressed = false;
+    }
+
+    static bool fWasPressed = false;
+
+    int fState = glfwGetKey(window, GLFW_KEY_F);
+    if (fState == GLFW_PRESS && !fWasPressed) {
+        PIPELINE_DEPTH = (PIPELINE_DEPTH + 1) % 3; // Cycle generating in the frame, 1 and 2 frames ahead
+        const char* names[] = { "off", "1 frame ahead", "2 frames ahead" };
+        std::cout << "PIPELINE_DEPTH switched to " << names[PIPELINE_DEPTH] << std::endl;
+        fWasPressed = true;
+    }
+    if (fState == GLFW_RELEASE) {
+        fWasPressed = false;
+    }
+
+    static bool tWasPressed = false;
+
+    int tState = glfwGetKey(window, GLFW_KEY_T);
+    if (tState == GLFW_PRESS && !tWasPressed) {
+        RECORD_TIMINGS = (RECORD_TIMINGS + 1) % 2; // Toggle frame timing CSV recording
+        std::cout << "RECORD_TIMINGS switched to " << (RECORD_TIMINGS == 0 ? "off" : "frame_timings.csv") << std::endl;
+        tWasPressed = true;
+    }
+    if (tState == GLFW_RELEASE) {
+        tWasPressed = false;
+    }
 }
 
 // framebuffer resize callback
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    glViewport(0, 0, width, height);
+    // Only recorded here, the render loop resizes everything once per frame
+    framebufferWidth = width;
+    framebufferHeight = height;
 }
 
 // mouse callback
 void mouse_callback(GLFWwindow* window, double xposIn, double yposIn) {}
 
 // scroll callback
-void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {}
+// Zoom the dense series, the pyramid makes any zoom level cost the same
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    SERIES_ZOOM = std::clamp(SERIES_ZOOM * std::pow(0.8f, float(yoffset)), 1e-5f, 1.0f);
+}
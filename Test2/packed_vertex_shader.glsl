@@ -0,0 +1,34 @@
+#version 330 core
+// Packed Wu vertices: integer pixel coordinates and 8-bit coverage
+layout (location = 0) in vec2 aPixel;    // int16 x, y (pixels)
+layout (location = 1) in vec2 aCoverage; // uint8 coverage, uint8 color index
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform mat4 pixelToNdc;       // glm::ortho of the target the coordinates are relative to
+uniform vec3 lineColors[16];   // per-draw color table
+
+out vec4 vColor;
+
+void main() {
+    // Pixel center to NDC, done here instead of per pixel on the CPU
+    vec2 ndc = (pixelToNdc * vec4(aPixel, 0.0, 1.0)).xy;
+
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = vec4(lineColors[int(aCoverage.y)], aCoverage.x / 255.0);
+}
\ No newline at end of file
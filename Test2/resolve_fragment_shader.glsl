@@ -0,0 +1,17 @@
+#version 330 core
+// Coverage resolve: the accumulation buffer holds the premultiplied line
+// colors summed in rgb and the accumulated coverage in alpha, the weight
+// buffer the summed coverage. rgb / weight is the coverage-weighted mean
+// color, blended over the cleared cells.
+uniform sampler2D coverage;
+uniform sampler2D weight;
+
+out vec4 FragColor;
+
+void main()
+{
+    vec4 accumulated = texelFetch(coverage, ivec2(gl_FragCoord.xy), 0);
+    float total = texelFetch(weight, ivec2(gl_FragCoord.xy), 0).r;
+    vec3 color = total > 0.0 ? accumulated.rgb / total : vec3(0.0);
+    FragColor = vec4(color, clamp(accumulated.a, 0.0, 1.0));
+}
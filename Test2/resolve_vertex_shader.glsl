@@ -0,0 +1,7 @@
+#version 330 core
+// Full-screen triangle from gl_VertexID, no vertex buffer needed
+
+void main() {
+    vec2 pos = vec2((gl_VertexID == 1) ? 3.0 : -1.0, (gl_VertexID == 2) ? 3.0 : -1.0);
+    gl_Position = vec4(pos, 0.0, 1.0);
+}
@@ -0,0 +1,79 @@
+#version 330 core
+// LineScene: Wu quads of many lines with per-line style, no vertex attributes
+// Every line is 12 vertices, two triangles per cell for both cells, so
+// gl_VertexID gives the line ID and one glMultiDrawArrays draws any set of
+// line ranges. Endpoints and style are fetched from buffer textures by ID.
+// The quad is the one of gpu_line_quad_vertex_shader.glsl, widened for
+// thick lines, and shares gpu_line_quad_fragment_shader.glsl.
+
+uniform samplerBuffer lineEndpoints; // RGBA32F: x0, y0, x1, y1 (pixels)
+uniform samplerBuffer lineColors;    // RGBA8: rgb, opacity
+uniform samplerBuffer lineWidths;    // R32F: minor-axis thickness
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform vec2 targetSize; // pixel size the endpoints are relative to
+
+flat out vec4 vLine;  // major/minor endpoints after the steep swap, x0 <= x1
+flat out int vSteep;
+flat out vec4 vColor; // rgb, opacity
+flat out float vWidth;
+out vec2 vPixel;      // target pixel coordinates, pixel p is centered on p
+
+// Strip corners of the quad as two triangles
+const int CORNERS[6] = int[6](0, 1, 2, 2, 1, 3);
+
+void main() {
+    int id = gl_VertexID / 12;
+    int local = gl_VertexID % 12;
+    int corner = CORNERS[local % 6];
+
+    vec4 line = texelFetch(lineEndpoints, id);
+    float width = texelFetch(lineWidths, id).r;
+
+    float x0 = line.x, y0 = line.y, x1 = line.z, y1 = line.w;
+
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if (steep) { x0 = line.y; y0 = line.x; x1 = line.w; y1 = line.z; }
+    if (x0 > x1) {
+        float t = x0; x0 = x1; x1 = t;
+        t = y0; y0 = y1; y1 = t;
+    }
+
+    float dx = x1 - x0;
+    float gradient = (dx == 0.0) ? 1.0 : ((y1 - y0) / dx);
+    float xpxl1 = floor(x0);
+    float xpxl2 = ceil(x1);
+    float yend1 = y0 + gradient * (xpxl1 - x0);
+
+    // Half a pixel past the endpoint columns and far enough above and below
+    // the line for the band plus a sample half a pixel off center
+    float reach = max(2.0, 0.5 * width + 1.5);
+    float major = corner < 2 ? xpxl1 - 0.5 : xpxl2 + 0.5;
+    float minor = yend1 + gradient * (major - xpxl1) + (corner % 2 == 0 ? -reach : reach);
+
+    vec2 pixel = steep ? vec2(minor, major) : vec2(major, minor);
+    vPixel = pixel;
+    vLine = vec4(x0, y0, x1, y1);
+    vSteep = steep ? 1 : 0;
+    vColor = texelFetch(lineColors, id);
+    vWidth = width;
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + local / 6;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+}
@@ -0,0 +1,57 @@
+#version 330 core
+// GPU sine backend: only the pixel columns are uploaded (once), the curve
+// is evaluated here from time, so an animated frame uploads nothing.
+// Every column is stored twice, Wu reads both copies (floor and upper pixel),
+// Bresenham reads every second one.
+layout (location = 0) in float aColumn; // pixel x
+
+// Same cell table as vertex_shader.glsl
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform int lineMode;    // 0 = Bresenham, 1 = Xiaolin Wu
+uniform vec2 targetSize; // pixel size of the target
+uniform float amplitude; // pixels
+uniform float frequency; // controls wavelength
+uniform float time;      // phase
+uniform vec3 lineColor;  // Wu color
+
+out vec4 vColor;
+
+void main() {
+    float x = aColumn;
+    float y = floor(targetSize.y / 2.0) + amplitude * sin(frequency * x + time);
+
+    vec2 pixel;
+    float coverage = 1.0;
+    if (lineMode == 0) {
+        // Bresenham: just pixel centers (one vertex per column)
+        pixel = vec2(x, y);
+    }
+    else {
+        // Wu: use floor + fractional part (dont round)
+        int upper = gl_VertexID % 2; // 0 = floor pixel, 1 = the one above
+        float frac = y - floor(y);
+        pixel = vec2(x, floor(y) + float(upper));
+        coverage = upper == 1 ? frac : 1.0 - frac;
+    }
+
+    vec2 ndc = (2.0 * (pixel + 0.5)) / targetSize - 1.0;
+
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : vec4(lineColor, coverage);
+}
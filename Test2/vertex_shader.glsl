@@ -2,9 +2,36 @@
 layout (location = 0) in vec2 aPos;
 layout (location = 1) in vec4 aColor;
 
+// One entry per viewport cell, selected by cellOffset + gl_InstanceID
+// rect is the cell in window NDC (x0, y0, x1, y1)
+// color is the constant color used when useCellColor is set
+layout (std140) uniform Cells {
+    vec4 cellRect[4];
+    vec4 cellColor[4];
+};
+
+uniform int cellOffset;
+uniform bool useCellColor;
+uniform mat4 pixelToNdc; // identity for NDC input, glm::ortho for pixel input
+
 out vec4 vColor;
 
 void main() {
-    gl_Position = vec4(aPos, 0.0, 1.0);
-    vColor = aColor;
+    int cell = cellOffset + gl_InstanceID;
+    vec4 rect = cellRect[cell];
+
+    // The one pixel -> NDC transform, the rasterizers can skip theirs
+    vec2 ndc = (pixelToNdc * vec4(aPos, 0.0, 1.0)).xy;
+
+    // Map the cell-local NDC position into the cell rectangle
+    vec2 pos = mix(rect.xy, rect.zw, ndc * 0.5 + 0.5);
+    gl_Position = vec4(pos, 0.0, 1.0);
+
+    // Clip against the cell edges, like a per-cell glViewport would
+    gl_ClipDistance[0] = ndc.x + 1.0;
+    gl_ClipDistance[1] = 1.0 - ndc.x;
+    gl_ClipDistance[2] = ndc.y + 1.0;
+    gl_ClipDistance[3] = 1.0 - ndc.y;
+
+    vColor = useCellColor ? cellColor[cell] : aColor;
 }
\ No newline at end of file